@@ -1,11 +0,0 @@
-// Fill out your copyright notice in the Description page of Project Settings.
-
-
-#include "DMBehaviorTreeComponent.h"
-
-
-
-void UDMBehaviorTreeComponent::SetLooping(bool bEnabled)
-{
-	bLoopExecution = bEnabled;
-}
\ No newline at end of file
@@ -0,0 +1,763 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "AICompiledOptionSet.h"
+#include "AIOption.h"
+#include "AIConsideration.h"
+#include "DecisionMakerComponent.h"
+#include "UtilityAIStats.h"
+#include "AIDecisionRecording.h"
+#include "AICooldownStore.h"
+#include "AITargetGenerator.h"
+#include "AIDecisionGroup.h"
+#include "AIInputSource.h"
+#include "AIConsideration_ResponseCurve.h"
+#include "BehaviorTree/BehaviorTree.h"
+
+#include "VisualLogger/VisualLogger.h"
+
+
+FAIConsiderationScore FAICompiledResponseCurve::Score(const UAIConsideration* Consideration, const FDecisionMakerContext& Context) const
+{
+	float RawInput = 0.f;
+	if (!Context.ReplayFrame || !Context.ReplayFrame->FindInput(Consideration, Context.TargetIndex, RawInput))
+	{
+		RawInput = Input ? Input->GetSharedInput(Context) : 0.f;
+	}
+
+	if (Context.DecisionRecorder)
+	{
+		Context.DecisionRecorder->RecordInput(Consideration, Context.TargetIndex, RawInput);
+	}
+
+	return MakeScore(FAIResponseCurve::EvaluateFormula(Type, Slope, XShift, YShift, NormalizeInput(RawInput)));
+}
+
+float FAICompiledResponseCurve::NormalizeInput(float RawInput) const
+{
+	return FMath::GetMappedRangeValueClamped(InputRange, FVector2D(0.f, 1.f), RawInput);
+}
+
+FAIConsiderationScore FAICompiledResponseCurve::MakeScore(float CurveOutput) const
+{
+	const float Value = FMath::Lerp(OutputRange.X, OutputRange.Y, CurveOutput);
+
+	FAIConsiderationScore Score;
+	if (bApplyAsAddend)
+	{
+		Score.Addend = Value;
+	}
+	else
+	{
+		Score.Multiplier = Value;
+	}
+	return Score;
+}
+
+
+TSharedRef<FAICompiledOptionSet> FAICompiledOptionSet::Compile(TArrayView<UAIOption* const> InOptions)
+{
+	TSharedRef<FAICompiledOptionSet> Compiled = MakeShared<FAICompiledOptionSet>();
+
+	int32 NumConsiderations = 0;
+	for (const UAIOption* Option : InOptions)
+	{
+		if (Option)
+			NumConsiderations += Option->Considerations.Num();
+	}
+
+	Compiled->Options.Reserve(InOptions.Num());
+	Compiled->OptionNames.Reserve(InOptions.Num());
+	Compiled->Ranks.Reserve(InOptions.Num());
+	Compiled->BaseAddends.Reserve(InOptions.Num());
+	Compiled->BehaviorTrees.Reserve(InOptions.Num());
+	Compiled->ConsiderationOffsets.Reserve(InOptions.Num() + 1);
+	Compiled->ThreadSafeOptions.Reserve(InOptions.Num());
+	Compiled->MaxWeights.Reserve(InOptions.Num());
+	Compiled->CooldownNames.Reserve(InOptions.Num());
+	Compiled->TargetGenerators.Reserve(InOptions.Num());
+	Compiled->ExclusiveOptions.Reserve(InOptions.Num());
+	Compiled->Considerations.Reserve(NumConsiderations);
+
+	for (UAIOption* Option : InOptions)
+	{
+		if (!Option)
+			continue;
+
+		Compiled->Options.Add(Option);
+		Compiled->OptionNames.Add(Option->OptionName);
+		Compiled->Ranks.Add(Option->Rank);
+		Compiled->BaseAddends.Add(Option->BaseAddend);
+		Compiled->BehaviorTrees.Add(Option->BehaviorTree);
+		Compiled->CooldownNames.Add(Option->GetCooldownName());
+		Compiled->TargetGenerators.Add(Option->TargetGenerator);
+		Compiled->ExclusiveOptions.Add(Option->bExclusiveInGroup);
+		Compiled->ConsiderationOffsets.Add(Compiled->Considerations.Num());
+
+		const int32 FirstConsideration = Compiled->Considerations.Num();
+
+		bool bThreadSafe = true;
+		for (UAIConsideration* Consideration : Option->Considerations)
+		{
+			if (!Consideration)
+				continue;
+
+			FAICompiledConsideration& CompiledConsideration = Compiled->Considerations.AddDefaulted_GetRef();
+			CompiledConsideration.Consideration = Consideration;
+			CompiledConsideration.bThreadSafe = Consideration->IsThreadSafe();
+			CompiledConsideration.bSharedInGroup = Consideration->bSharedInGroup;
+			CompiledConsideration.CacheTimeToLive = Consideration->CacheTimeToLive;
+			CompiledConsideration.CacheKey = FAIConsiderationCacheKey::Make(Consideration, Consideration->CacheKey);
+
+			if (const UAIConsideration_ResponseCurve* ResponseCurve = Cast<UAIConsideration_ResponseCurve>(Consideration))
+			{
+				CompiledConsideration.bCompiledCurve = ResponseCurve->CompileResponseCurve(CompiledConsideration.ResponseCurve);
+			}
+
+			FAIConsiderationScore MaxScore;
+			if (Consideration->GetScoreBounds(MaxScore))
+			{
+				CompiledConsideration.RemainingMaxAddend = MaxScore.Addend;
+				CompiledConsideration.RemainingMaxMultiplier = MaxScore.Multiplier;
+			}
+			else
+			{
+				CompiledConsideration.RemainingMaxAddend = INFINITY;
+				CompiledConsideration.RemainingMaxMultiplier = INFINITY;
+			}
+
+			bThreadSafe &= CompiledConsideration.bThreadSafe;
+		}
+		if (Option->TargetGenerator)
+		{
+			bThreadSafe &= Option->TargetGenerator->IsThreadSafe();
+		}
+		Compiled->ThreadSafeOptions.Add(bThreadSafe);
+
+		// Accumulate the bounds from the back, so each consideration knows the best that the rest of the option can do
+		float RemainingMaxAddend = 0.f;
+		float RemainingMaxMultiplier = 1.f;
+		for (int32 Index = Compiled->Considerations.Num() - 1; Index >= FirstConsideration; --Index)
+		{
+			FAICompiledConsideration& CompiledConsideration = Compiled->Considerations[Index];
+			RemainingMaxAddend += CompiledConsideration.RemainingMaxAddend;
+			RemainingMaxMultiplier *= CompiledConsideration.RemainingMaxMultiplier;
+			CompiledConsideration.RemainingMaxAddend = RemainingMaxAddend;
+			CompiledConsideration.RemainingMaxMultiplier = RemainingMaxMultiplier;
+		}
+		Compiled->MaxWeights.Add(GetMaxWeight(Option->BaseAddend, 1.f, RemainingMaxAddend, RemainingMaxMultiplier));
+	}
+
+	// Close off the last option's range
+	Compiled->ConsiderationOffsets.Add(Compiled->Considerations.Num());
+
+	return Compiled;
+}
+
+SIZE_T FAICompiledOptionSet::GetAllocatedSize() const
+{
+	return Options.GetAllocatedSize() + OptionNames.GetAllocatedSize() + Ranks.GetAllocatedSize() + BaseAddends.GetAllocatedSize()
+		+ BehaviorTrees.GetAllocatedSize() + ConsiderationOffsets.GetAllocatedSize() + ThreadSafeOptions.GetAllocatedSize() + MaxWeights.GetAllocatedSize()
+		+ CooldownNames.GetAllocatedSize() + TargetGenerators.GetAllocatedSize() + ExclusiveOptions.GetAllocatedSize() + Considerations.GetAllocatedSize();
+}
+
+int32 FAICompiledOptionSet::FindOptionIndex(const UAIOption* Option) const
+{
+	return Options.IndexOfByKey(Option);
+}
+
+TArrayView<const FAICompiledConsideration> FAICompiledOptionSet::GetConsiderations(int32 OptionIndex) const
+{
+	const int32 First = ConsiderationOffsets[OptionIndex];
+	return MakeArrayView(Considerations.GetData() + First, ConsiderationOffsets[OptionIndex + 1] - First);
+}
+
+bool FAICompiledOptionSet::UsesConsideration(int32 OptionIndex, const UAIConsideration* Consideration) const
+{
+	for (const FAICompiledConsideration& CompiledConsideration : GetConsiderations(OptionIndex))
+	{
+		if (CompiledConsideration.Consideration == Consideration)
+			return true;
+	}
+	return false;
+}
+
+void FAICompiledOptionSet::GetReferencedObjects(TSet<UObject*>& OutObjects) const
+{
+	for (int32 OptionIndex = 0; OptionIndex < Num(); ++OptionIndex)
+	{
+		OutObjects.Add(Options[OptionIndex]);
+		OutObjects.Add(BehaviorTrees[OptionIndex]);
+		OutObjects.Add(const_cast<UAITargetGenerator*>(TargetGenerators[OptionIndex]));
+	}
+
+	for (const FAICompiledConsideration& CompiledConsideration : Considerations)
+	{
+		OutObjects.Add(CompiledConsideration.Consideration);
+		OutObjects.Add(const_cast<UAIInputSource*>(CompiledConsideration.ResponseCurve.Input));
+	}
+
+	OutObjects.Remove(nullptr);
+}
+
+FAIConsiderationScore FAICompiledOptionSet::ScoreConsideration(const FAICompiledConsideration& CompiledConsideration, const FDecisionMakerContext& Context, bool& bOutFromCache)
+{
+	UAIConsideration* Consideration = CompiledConsideration.Consideration;
+
+	FAIConsiderationScore Score;
+	float RawInput = 0.f;
+
+	// Replays hand back the recorded score, unless there's a recorded input to score again.
+	// Anything else would have to query a world that replays don't have, so a missing score is reported instead.
+	if (Context.ReplayFrame && !Context.ReplayFrame->FindInput(Consideration, Context.TargetIndex, RawInput))
+	{
+		if (!Context.ReplayFrame->FindScore(Consideration, Context.TargetIndex, Score))
+		{
+			Context.ReplayFrame->ReportMissingScore(Consideration);
+			Score.Multiplier = 0.f;
+		}
+		bOutFromCache = true;
+		return Score;
+	}
+
+	// Scored once for the whole group
+	const bool bShareInGroup = CompiledConsideration.bSharedInGroup && Context.DecisionGroup;
+	if (bShareInGroup && Context.DecisionGroup->FindSharedScore(Consideration, Score))
+	{
+		INC_DWORD_STAT(STAT_UtilityAI_ConsiderationsSharedInGroup);
+		bOutFromCache = true;
+		if (Context.DecisionRecorder)
+		{
+			Context.DecisionRecorder->RecordScore(Consideration, Context.TargetIndex, Score);
+		}
+		return Score;
+	}
+
+	const bool bUseCache = CompiledConsideration.CacheTimeToLive > 0 && Context.ConsiderationCache;
+
+	bOutFromCache = bUseCache && Context.ConsiderationCache->Find(CompiledConsideration.CacheKey, Context.CurrentTime, Score);
+	if (bOutFromCache)
+	{
+		INC_DWORD_STAT(STAT_UtilityAI_ConsiderationsFromCache);
+		if (Context.DecisionRecorder)
+		{
+			Context.DecisionRecorder->RecordScore(Consideration, Context.TargetIndex, Score);
+		}
+		return Score;
+	}
+
+	UTILITYAI_TRACE_SCOPE_DYNAMIC(Consideration->GetClass()->GetName());
+	INC_DWORD_STAT(STAT_UtilityAI_ConsiderationsScored);
+
+	const bool bCollectTimings = FAIConsiderationTimings::IsEnabled();
+	const double StartSeconds = bCollectTimings ? FPlatformTime::Seconds() : 0.0;
+
+	// Compiled curves don't need the consideration at all. Other thread-safe considerations are always native,
+	// so we can skip the script VM and call the implementation directly.
+	if (CompiledConsideration.bCompiledCurve)
+	{
+		Score = CompiledConsideration.ResponseCurve.Score(Consideration, Context);
+	}
+	else
+	{
+		Score = CompiledConsideration.bThreadSafe
+			? Consideration->CalculateScore_Implementation(Context)
+			: Consideration->CalculateScore(Context);
+	}
+
+	if (bCollectTimings)
+	{
+		FAIConsiderationTimings::Get().Add(Consideration->GetClass(), FPlatformTime::Seconds() - StartSeconds);
+	}
+
+	if (bUseCache)
+	{
+		Context.ConsiderationCache->Add(CompiledConsideration.CacheKey, Score, Context.CurrentTime + CompiledConsideration.CacheTimeToLive);
+	}
+
+	if (bShareInGroup)
+	{
+		Context.DecisionGroup->AddSharedScore(Consideration, Score);
+	}
+
+	if (Context.DecisionRecorder)
+	{
+		Context.DecisionRecorder->RecordScore(Consideration, Context.TargetIndex, Score);
+	}
+
+	return Score;
+}
+
+float FAICompiledOptionSet::GetMaxWeight(float AddendSum, float MultiplierProduct, float RemainingMaxAddend, float RemainingMaxMultiplier)
+{
+	// A product of 0 stays 0, whatever the rest of the considerations return
+	if (MultiplierProduct == 0)
+		return 0.f;
+
+	// Unbounded considerations still to come could return anything, including a multiplier that flips the sign back
+	if (!FMath::IsFinite(RemainingMaxAddend) || !FMath::IsFinite(RemainingMaxMultiplier))
+		return INFINITY;
+
+	// Bounded multipliers are never negative, but bounds only cap addends from above. A negative product times
+	// an addend sum that ends up negative is a positive weight, so there's no telling how good the option could get.
+	if (MultiplierProduct < 0)
+		return RemainingMaxMultiplier > 0 ? INFINITY : 0.f;
+
+	// Otherwise the best case is the biggest addend times the biggest multiplier. Anything that ends up at or below 0 gets thrown away anyway.
+	const float MaxAddendSum = AddendSum + RemainingMaxAddend;
+	if (MaxAddendSum <= 0 || RemainingMaxMultiplier <= 0)
+		return 0.f;
+
+	return MaxAddendSum * MultiplierProduct * RemainingMaxMultiplier;
+}
+
+FAIOptionScore FAICompiledOptionSet::ScoreOption(int32 OptionIndex, const FDecisionMakerContext& Context, float MinimumWeight) const
+{
+	SCOPE_CYCLE_COUNTER(STAT_UtilityAI_ScoreOption);
+	UTILITYAI_TRACE_SCOPE_DYNAMIC(OptionNames[OptionIndex].ToString());
+	INC_DWORD_STAT(STAT_UtilityAI_OptionsScored);
+
+	FAIOptionScore OptionScore;
+	OptionScore.Option = Options[OptionIndex];
+	OptionScore.Rank = Ranks[OptionIndex];
+	OptionScore.Weight = 0.f; // default to 0 weight
+
+	if (Context.Cooldowns && Context.Cooldowns->IsActive(CooldownNames[OptionIndex], Context.CurrentTime))
+	{
+		INC_DWORD_STAT(STAT_UtilityAI_OptionsOnCooldown);
+		if (Context.DecisionRecorder)
+		{
+			Context.DecisionRecorder->RecordCooldown(CooldownNames[OptionIndex]);
+		}
+		return OptionScore;
+	}
+
+	// Another member of the group has this one. Replays have no group, so they go by the recorded claims.
+	const bool bClaimedByOther = Context.ReplayFrame
+		? Context.ReplayFrame->IsClaimed(OptionNames[OptionIndex])
+		: Context.DecisionGroup && ExclusiveOptions[OptionIndex] && Context.DecisionGroup->IsClaimedByOther(OptionNames[OptionIndex], Context.DecisionMaker);
+	if (bClaimedByOther)
+	{
+		INC_DWORD_STAT(STAT_UtilityAI_OptionsClaimedInGroup);
+		if (Context.DecisionRecorder)
+		{
+			Context.DecisionRecorder->RecordClaim(OptionNames[OptionIndex]);
+		}
+		return OptionScore;
+	}
+
+	// Recordings need every consideration's score, so don't stop early while recording
+	const bool bAllowEarlyOut = !Context.DecisionRecorder;
+
+	// Don't bother if this option can't make the cut, even with perfect scores
+	if (bAllowEarlyOut && (MaxWeights[OptionIndex] <= 0 || MaxWeights[OptionIndex] < MinimumWeight))
+	{
+		OptionScore.bPruned = true;
+		INC_DWORD_STAT(STAT_UtilityAI_OptionEarlyOuts);
+		return OptionScore;
+	}
+
+	if (TargetGenerators[OptionIndex])
+	{
+		ScoreTargets(OptionIndex, Context, MinimumWeight, bAllowEarlyOut, OptionScore);
+		return OptionScore;
+	}
+
+	float AddendSum = BaseAddends[OptionIndex];
+	float MultiplierProduct = 1.f;
+
+#if ENABLE_VISUAL_LOG
+	// Only log from the game thread, and only when we know who to log against
+	const AActor* LogOwner = Context.DecisionMaker && IsInGameThread() ? Context.DecisionMaker->GetOwner() : nullptr;
+	if (LogOwner && FVisualLogger::Get().IsRecording())
+	{
+		UE_VLOG_UELOG(LogOwner, LogDM, Verbose, TEXT("(%s)..."), *OptionNames[OptionIndex].ToString());
+	}
+#endif //ENABLE_VISUAL_LOG
+
+	TArrayView<const FAICompiledConsideration> OptionConsiderations = GetConsiderations(OptionIndex);
+
+	// Run through each consideration to gather consideration scores
+	for (int32 Index = 0; Index < OptionConsiderations.Num(); ++Index)
+	{
+		const FAICompiledConsideration& CompiledConsideration = OptionConsiderations[Index];
+		UAIConsideration* Consideration = CompiledConsideration.Consideration;
+
+		bool bFromCache = false;
+		FAIConsiderationScore ConsiderationScore = ScoreConsideration(CompiledConsideration, Context, bFromCache);
+
+		AddendSum += ConsiderationScore.Addend;
+		MultiplierProduct *= ConsiderationScore.Multiplier;
+
+#if ENABLE_VISUAL_LOG
+		if (LogOwner && FVisualLogger::Get().IsRecording())
+		{
+			UE_VLOG_UELOG(LogOwner, LogDM, Verbose, TEXT("- Addend: %f Multiplier: %f    [%s]%s"),
+				ConsiderationScore.Addend, ConsiderationScore.Multiplier, *Consideration->GetConsiderationDescription(), bFromCache ? TEXT(" (cached)") : TEXT(""));
+		}
+#endif //ENABLE_VISUAL_LOG
+
+		// Exit early if we have a multiplier of 0. It's unrecoverable.
+		if (MultiplierProduct == 0 && bAllowEarlyOut)
+		{
+			INC_DWORD_STAT(STAT_UtilityAI_OptionEarlyOuts);
+			return OptionScore;
+		}
+
+		// Exit early if the considerations we haven't run yet can't get us up to the minimum weight
+		if (bAllowEarlyOut && OptionConsiderations.IsValidIndex(Index + 1))
+		{
+			const FAICompiledConsideration& NextConsideration = OptionConsiderations[Index + 1];
+			const float MaxWeight = GetMaxWeight(AddendSum, MultiplierProduct, NextConsideration.RemainingMaxAddend, NextConsideration.RemainingMaxMultiplier);
+			if (MaxWeight <= 0 || MaxWeight < MinimumWeight)
+			{
+				OptionScore.bPruned = true;
+				INC_DWORD_STAT(STAT_UtilityAI_OptionEarlyOuts);
+				return OptionScore;
+			}
+		}
+	}
+
+	OptionScore.Weight = AddendSum * MultiplierProduct;
+
+	return OptionScore;
+}
+
+void FAICompiledOptionSet::ScoreTargets(int32 OptionIndex, const FDecisionMakerContext& Context, float MinimumWeight, bool bAllowEarlyOut, FAIOptionScore& OutScore) const
+{
+	// Scratch space, reused by every targeted option scored on this thread
+	static thread_local TArray<AActor*> Targets;
+	static thread_local TArray<FDecisionMakerContext> TargetContexts;
+	static thread_local TArray<float> AddendSums;
+	static thread_local TArray<float> MultiplierProducts;
+	static thread_local TArray<FAIConsiderationScore> ConsiderationScores;
+
+	Targets.Reset();
+	TargetContexts.Reset();
+
+	// Scores depend on the target, so they can't go in the agent's cache. Recordings keep them apart by TargetIndex.
+	auto AddTargetContext = [&Context](AActor* Target) -> FDecisionMakerContext&
+	{
+		FDecisionMakerContext& TargetContext = TargetContexts.Add_GetRef(Context);
+		TargetContext.Target = Target;
+		TargetContext.TargetIndex = TargetContexts.Num() - 1;
+		TargetContext.ConsiderationCache = nullptr;
+		TargetContext.DecisionGroup = nullptr;
+		return TargetContext;
+	};
+
+	if (Context.ReplayFrame)
+	{
+		// Replays have no actors, just as many targets as were recorded
+		const int32 NumRecordedTargets = Context.ReplayFrame->GetNumTargets(Options[OptionIndex]);
+		for (int32 TargetIndex = 0; TargetIndex < NumRecordedTargets; ++TargetIndex)
+		{
+			AddTargetContext(nullptr);
+		}
+	}
+	else
+	{
+		TargetGenerators[OptionIndex]->GenerateTargets(Context, Targets);
+		for (AActor* Target : Targets)
+		{
+			if (Target)
+			{
+				AddTargetContext(Target);
+			}
+		}
+
+		if (Context.DecisionRecorder)
+		{
+			Context.DecisionRecorder->RecordTargets(Options[OptionIndex], TargetContexts.Num());
+		}
+	}
+
+	int32 NumTargets = TargetContexts.Num();
+	if (NumTargets == 0)
+		return;
+
+	AddendSums.Init(BaseAddends[OptionIndex], NumTargets);
+	MultiplierProducts.Init(1.f, NumTargets);
+
+	// Set once a target is dropped for falling short of MinimumWeight. Targets with a 0 product really are worth nothing.
+	bool bDroppedByBound = false;
+
+	TArrayView<const FAICompiledConsideration> OptionConsiderations = GetConsiderations(OptionIndex);
+	for (int32 Index = 0; Index < OptionConsiderations.Num(); ++Index)
+	{
+		const FAICompiledConsideration& CompiledConsideration = OptionConsiderations[Index];
+		ConsiderationScores.SetNum(NumTargets, EAllowShrinking::No);
+
+		if (Context.ReplayFrame)
+		{
+			// Recorded scores are looked up one target at a time
+			for (int32 TargetIndex = 0; TargetIndex < NumTargets; ++TargetIndex)
+			{
+				bool bFromCache = false;
+				ConsiderationScores[TargetIndex] = ScoreConsideration(CompiledConsideration, TargetContexts[TargetIndex], bFromCache);
+			}
+		}
+		else
+		{
+			UAIConsideration* Consideration = CompiledConsideration.Consideration;
+
+			UTILITYAI_TRACE_SCOPE_DYNAMIC(Consideration->GetClass()->GetName());
+			INC_DWORD_STAT_BY(STAT_UtilityAI_ConsiderationsScored, NumTargets);
+
+			const bool bCollectTimings = FAIConsiderationTimings::IsEnabled();
+			const double StartSeconds = bCollectTimings ? FPlatformTime::Seconds() : 0.0;
+
+			Consideration->CalculateScoreBatch(MakeArrayView(TargetContexts.GetData(), NumTargets), ConsiderationScores);
+
+			if (bCollectTimings)
+			{
+				FAIConsiderationTimings::Get().Add(Consideration->GetClass(), FPlatformTime::Seconds() - StartSeconds, NumTargets);
+			}
+
+			if (Context.DecisionRecorder)
+			{
+				for (int32 TargetIndex = 0; TargetIndex < NumTargets; ++TargetIndex)
+				{
+					Context.DecisionRecorder->RecordScore(Consideration, TargetContexts[TargetIndex].TargetIndex, ConsiderationScores[TargetIndex]);
+				}
+			}
+		}
+
+		const FAICompiledConsideration* NextConsideration = OptionConsiderations.IsValidIndex(Index + 1) ? &OptionConsiderations[Index + 1] : nullptr;
+
+		// Accumulate, and pack the targets that can still reach the minimum weight to the front
+		int32 NumKept = 0;
+		for (int32 TargetIndex = 0; TargetIndex < NumTargets; ++TargetIndex)
+		{
+			const float AddendSum = AddendSums[TargetIndex] + ConsiderationScores[TargetIndex].Addend;
+			const float MultiplierProduct = MultiplierProducts[TargetIndex] * ConsiderationScores[TargetIndex].Multiplier;
+
+			if (bAllowEarlyOut)
+			{
+				if (MultiplierProduct == 0)
+					continue;
+
+				if (NextConsideration)
+				{
+					const float MaxWeight = GetMaxWeight(AddendSum, MultiplierProduct, NextConsideration->RemainingMaxAddend, NextConsideration->RemainingMaxMultiplier);
+					if (MaxWeight <= 0 || MaxWeight < MinimumWeight)
+					{
+						bDroppedByBound = true;
+						continue;
+					}
+				}
+			}
+
+			if (NumKept != TargetIndex)
+			{
+				TargetContexts[NumKept] = TargetContexts[TargetIndex];
+			}
+			AddendSums[NumKept] = AddendSum;
+			MultiplierProducts[NumKept] = MultiplierProduct;
+			++NumKept;
+		}
+
+		NumTargets = NumKept;
+		if (NumTargets == 0)
+		{
+			// Same as an untargeted option: the caller may still need the real weight, eg. to hold on to a running option
+			OutScore.bPruned = bDroppedByBound;
+			INC_DWORD_STAT(STAT_UtilityAI_OptionEarlyOuts);
+			return;
+		}
+	}
+
+	int32 BestIndex = 0;
+	float BestWeight = AddendSums[0] * MultiplierProducts[0];
+	for (int32 TargetIndex = 1; TargetIndex < NumTargets; ++TargetIndex)
+	{
+		const float Weight = AddendSums[TargetIndex] * MultiplierProducts[TargetIndex];
+		if (Weight > BestWeight)
+		{
+			BestIndex = TargetIndex;
+			BestWeight = Weight;
+		}
+	}
+
+	OutScore.Weight = BestWeight;
+	OutScore.Target = TargetContexts[BestIndex].Target;
+
+#if ENABLE_VISUAL_LOG
+	const AActor* LogOwner = Context.DecisionMaker && IsInGameThread() ? Context.DecisionMaker->GetOwner() : nullptr;
+	if (LogOwner && FVisualLogger::Get().IsRecording())
+	{
+		UE_VLOG_UELOG(LogOwner, LogDM, Verbose, TEXT("(%s) %d targets left, best: %s (%f)"),
+			*OptionNames[OptionIndex].ToString(), NumTargets, *GetNameSafe(OutScore.Target), BestWeight);
+	}
+#endif //ENABLE_VISUAL_LOG
+}
+
+namespace AISortedOptionList
+{
+	// Every list handed out by FAISortedOptionList::Get. Lists go away when the last agent using them lets go.
+	static FCriticalSection RegistryLock;
+	static TArray<TWeakPtr<const FAISortedOptionList>> Registry;
+}
+
+TSharedRef<const FAISortedOptionList> FAISortedOptionList::Get(TArrayView<const TSharedRef<const FAICompiledOptionSet>> InSources)
+{
+	FScopeLock ScopeLock(&AISortedOptionList::RegistryLock);
+
+	TArray<TWeakPtr<const FAISortedOptionList>>& Registry = AISortedOptionList::Registry;
+	for (int32 Index = Registry.Num() - 1; Index >= 0; --Index)
+	{
+		TSharedPtr<const FAISortedOptionList> List = Registry[Index].Pin();
+		if (!List)
+		{
+			Registry.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+			continue;
+		}
+
+		if (List->HasSources(InSources))
+			return List.ToSharedRef();
+	}
+
+	TSharedRef<FAISortedOptionList> List = MakeShared<FAISortedOptionList>();
+	List->Sources.Append(InSources.GetData(), InSources.Num());
+
+	for (const TSharedRef<const FAICompiledOptionSet>& CompiledOptionSet : List->Sources)
+	{
+		for (int32 OptionIndex = 0; OptionIndex < CompiledOptionSet->Num(); ++OptionIndex)
+		{
+			List->Options.Add({ &CompiledOptionSet.Get(), OptionIndex });
+			List->bAllThreadSafe &= CompiledOptionSet->ThreadSafeOptions[OptionIndex];
+		}
+	}
+
+	AIOptionRanking::SortByRank(List->Options);
+
+	TSet<UObject*> ReferencedObjects;
+	for (const TSharedRef<const FAICompiledOptionSet>& CompiledOptionSet : List->Sources)
+	{
+		CompiledOptionSet->GetReferencedObjects(ReferencedObjects);
+	}
+	List->ReferencedObjects = ReferencedObjects.Array();
+
+	FString Name;
+	for (const TSharedRef<const FAICompiledOptionSet>& CompiledOptionSet : List->Sources)
+	{
+		if (!Name.IsEmpty())
+		{
+			Name += TEXT("+");
+		}
+		Name += CompiledOptionSet->SourcePath.IsNull() ? FString(TEXT("(unnamed)")) : CompiledOptionSet->SourcePath.GetAssetName();
+	}
+	List->Name = Name.IsEmpty() ? FName(TEXT("(empty)")) : FName(*Name.Left(NAME_SIZE - 1));
+
+	Registry.Add(List);
+	return List;
+}
+
+void FAISortedOptionList::GetSharedStats(int32& OutNumLists, SIZE_T& OutAllocatedSize)
+{
+	FScopeLock ScopeLock(&AISortedOptionList::RegistryLock);
+
+	OutNumLists = 0;
+	OutAllocatedSize = 0;
+	for (const TWeakPtr<const FAISortedOptionList>& WeakList : AISortedOptionList::Registry)
+	{
+		if (TSharedPtr<const FAISortedOptionList> List = WeakList.Pin())
+		{
+			++OutNumLists;
+			OutAllocatedSize += sizeof(FAISortedOptionList) + List->GetAllocatedSize();
+		}
+	}
+}
+
+bool FAISortedOptionList::HasSources(TArrayView<const TSharedRef<const FAICompiledOptionSet>> InSources) const
+{
+	if (Sources.Num() != InSources.Num())
+		return false;
+
+	for (int32 Index = 0; Index < Sources.Num(); ++Index)
+	{
+		if (Sources[Index] != InSources[Index])
+			return false;
+	}
+	return true;
+}
+
+SIZE_T FAISortedOptionList::GetAllocatedSize() const
+{
+	return Sources.GetAllocatedSize() + Options.GetAllocatedSize() + ReferencedObjects.GetAllocatedSize();
+}
+
+void FAISortedOptionList::AddReferencedObjects(FReferenceCollector& Collector)
+{
+	Collector.AddReferencedObjects(ReferencedObjects);
+}
+
+FString FAISortedOptionList::GetReferencerName() const
+{
+	return TEXT("FAISortedOptionList");
+}
+
+void AIOptionRanking::SortByRank(TArray<FAIOptionRef>& Options)
+{
+	// Sets go in the order their options first appear
+	TMap<const FAICompiledOptionSet*, int32, TInlineSetAllocator<8>> SetOrder;
+	for (const FAIOptionRef& OptionRef : Options)
+	{
+		if (!SetOrder.Contains(OptionRef.OptionSet))
+		{
+			SetOrder.Add(OptionRef.OptionSet, SetOrder.Num());
+		}
+	}
+
+	Options.StableSort([&SetOrder](const FAIOptionRef& A, const FAIOptionRef& B)
+	{
+		if (A.GetRank() != B.GetRank())
+			return A.GetRank() > B.GetRank();
+
+		if (A.OptionSet != B.OptionSet)
+			return SetOrder[A.OptionSet] < SetOrder[B.OptionSet];
+
+		return A.GetMaxWeight() > B.GetMaxWeight();
+	});
+}
+
+int32 AIOptionRanking::FindRankEnd(TArrayView<const FAIOptionRef> SortedOptions, int32 Start)
+{
+	const float Rank = SortedOptions[Start].GetRank();
+
+	int32 End = Start + 1;
+	while (End < SortedOptions.Num() && SortedOptions[End].GetRank() == Rank)
+	{
+		++End;
+	}
+	return End;
+}
+
+float AIOptionRanking::ScoreBestRank(TArrayView<const FAIOptionRef> SortedOptions, const FDecisionMakerContext& Context, float PruneFraction,
+	TArrayView<FAIOptionScore> OutScores, int32& OutRankStart, int32& OutRankNum)
+{
+	check(SortedOptions.Num() == OutScores.Num());
+
+	float BestWeight = 0.f;
+	OutRankStart = 0;
+	OutRankNum = 0;
+
+	int32 RankStart = 0;
+	while (RankStart < SortedOptions.Num() && BestWeight <= 0)
+	{
+		const int32 RankEnd = FindRankEnd(SortedOptions, RankStart);
+
+		for (int32 Index = RankStart; Index < RankEnd; ++Index)
+		{
+			const FAIOptionRef& OptionRef = SortedOptions[Index];
+			OutScores[Index] = OptionRef.OptionSet->ScoreOption(OptionRef.OptionIndex, Context, BestWeight * PruneFraction);
+			BestWeight = FMath::Max(BestWeight, OutScores[Index].Weight);
+		}
+
+		OutRankStart = RankStart;
+		OutRankNum = RankEnd - RankStart;
+		RankStart = RankEnd;
+	}
+
+	return BestWeight;
+}
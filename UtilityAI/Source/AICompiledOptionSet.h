@@ -0,0 +1,215 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/GCObject.h"
+#include "AIShared.h"
+#include "AIConsiderationCache.h"
+#include "AIResponseCurve.h"
+
+
+class UAIOption;
+class UAIConsideration;
+class UBehaviorTree;
+class UAITargetGenerator;
+class UAIInputSource;
+
+/**
+ * Parameters of a native response curve consideration, copied into the compiled set
+ * so scoring doesn't have to read them from the consideration or call into it.
+ */
+struct UTILITYAI_API FAICompiledResponseCurve
+{
+	const UAIInputSource* Input = nullptr;
+
+	FVector2D InputRange = FVector2D(0.f, 1.f);
+
+	FVector2D OutputRange = FVector2D(0.f, 1.f);
+
+	// Only formula curves are copied. Custom curves are scored by the consideration.
+	EAIResponseCurveType Type = EAIResponseCurveType::Linear;
+
+	float Slope = 1.f;
+
+	float XShift = 0.f;
+
+	float YShift = 0.f;
+
+	bool bApplyAsAddend = false;
+
+	// Read the input (or the recorded one in replays), record it if recording, and run it through the curve
+	FAIConsiderationScore Score(const UAIConsideration* Consideration, const FDecisionMakerContext& Context) const;
+
+	// Map a raw input value to 0-1
+	float NormalizeInput(float RawInput) const;
+
+	// Map the curve's 0-1 result to OutputRange, as an addend or multiplier
+	FAIConsiderationScore MakeScore(float CurveOutput) const;
+};
+
+/** Everything the scoring loop needs to know about one consideration, stored contiguously for the whole set */
+struct FAICompiledConsideration
+{
+	UAIConsideration* Consideration = nullptr;
+
+	bool bThreadSafe = false;
+
+	bool bSharedInGroup = false;
+
+	// Scored from ResponseCurve instead of calling the consideration
+	bool bCompiledCurve = false;
+
+	FAICompiledResponseCurve ResponseCurve;
+
+	// Upper bounds for this consideration and all the ones after it in the option. Infinite if any of them are unbounded.
+	float RemainingMaxAddend = 0.f;
+	float RemainingMaxMultiplier = 1.f;
+
+	// 0 if the score shouldn't be cached
+	float CacheTimeToLive = 0.f;
+
+	FAIConsiderationCacheKey CacheKey;
+};
+
+/**
+ * Flattened, immutable copy of a list of options.
+ * Per-option data is kept in parallel arrays and each option owns a contiguous range of Considerations,
+ * so scoring walks flat arrays instead of the UObject graph.
+ * Built by UAIOptionSetDataAsset::GetCompiledOptionSet and shared by every agent using that asset.
+ */
+struct UTILITYAI_API FAICompiledOptionSet
+{
+	// --- Per option ---
+
+	TArray<UAIOption*> Options;
+
+	TArray<FName> OptionNames;
+
+	TArray<float> Ranks;
+
+	TArray<float> BaseAddends;
+
+	TArray<UBehaviorTree*> BehaviorTrees;
+
+	// Option i uses Considerations[ConsiderationOffsets[i], ConsiderationOffsets[i + 1]). Has one more entry than Options.
+	TArray<int32> ConsiderationOffsets;
+
+	// True if every consideration in the option can be scored off the game thread
+	TArray<bool> ThreadSafeOptions;
+
+	// Best weight the option could possibly get. Infinite if any of its considerations are unbounded.
+	TArray<float> MaxWeights;
+
+	// The option can't be picked while the cooldown with this name is running
+	TArray<FName> CooldownNames;
+
+	// Options with a generator are scored once per target, see ScoreTargets
+	TArray<const UAITargetGenerator*> TargetGenerators;
+
+	// Only one member of a decision group can hold the option
+	TArray<bool> ExclusiveOptions;
+
+	// --- Per consideration ---
+
+	TArray<FAICompiledConsideration> Considerations;
+
+	// Asset this set was compiled from, if any. Recordings use it to find the set again.
+	FSoftObjectPath SourcePath;
+
+
+	static TSharedRef<FAICompiledOptionSet> Compile(TArrayView<UAIOption* const> InOptions);
+
+	int32 Num() const { return Options.Num(); }
+
+	SIZE_T GetAllocatedSize() const;
+
+	int32 FindOptionIndex(const UAIOption* Option) const;
+
+	TArrayView<const FAICompiledConsideration> GetConsiderations(int32 OptionIndex) const;
+
+	bool UsesConsideration(int32 OptionIndex, const UAIConsideration* Consideration) const;
+
+	// Add every UObject this set points to
+	void GetReferencedObjects(TSet<UObject*>& OutObjects) const;
+
+	// Run the option's considerations and combine them into a weight. Safe to call from a worker thread if ThreadSafeOptions[OptionIndex] is set.
+	// Scoring stops early (with 0 weight and bPruned set) once the option can't reach MinimumWeight.
+	// Options on cooldown get 0 weight without running any considerations.
+	FAIOptionScore ScoreOption(int32 OptionIndex, const FDecisionMakerContext& Context, float MinimumWeight = 0.f) const;
+
+	// Score a targeted option for all of its targets at once. Each consideration gets the whole batch of targets still in the running,
+	// and the best target's weight and actor go in OutScore.
+	void ScoreTargets(int32 OptionIndex, const FDecisionMakerContext& Context, float MinimumWeight, bool bAllowEarlyOut, FAIOptionScore& OutScore) const;
+
+	// Get one consideration's score, from the agent's cache if it has a fresh one
+	static FAIConsiderationScore ScoreConsideration(const FAICompiledConsideration& CompiledConsideration, const FDecisionMakerContext& Context, bool& bOutFromCache);
+
+	// Best weight an option could end up with, given the scores so far and the bounds of the considerations still to run
+	static float GetMaxWeight(float AddendSum, float MultiplierProduct, float RemainingMaxAddend, float RemainingMaxMultiplier);
+};
+
+/** One option inside a compiled set */
+struct FAIOptionRef
+{
+	const FAICompiledOptionSet* OptionSet = nullptr;
+
+	int32 OptionIndex = INDEX_NONE;
+
+	float GetRank() const { return OptionSet->Ranks[OptionIndex]; }
+
+	float GetMaxWeight() const { return OptionSet->MaxWeights[OptionIndex]; }
+
+	bool IsThreadSafe() const { return OptionSet->ThreadSafeOptions[OptionIndex]; }
+};
+
+/**
+ * Every option from a list of compiled sets, sorted by rank.
+ * Immutable and shared by everything that uses the same sets, so agents don't each carry their own copy.
+ * Compiled sets only hold raw pointers and can outlive their asset, so the list keeps everything they point to alive while it's in use.
+ */
+struct UTILITYAI_API FAISortedOptionList : public FGCObject
+{
+	// The compiled sets Options points into. Holding them keeps the options alive if an asset gets recompiled.
+	TArray<TSharedRef<const FAICompiledOptionSet>> Sources;
+
+	TArray<FAIOptionRef> Options;
+
+	// True if every option can be scored off the game thread
+	bool bAllThreadSafe = true;
+
+	// The source assets' names joined with '+', for reporting which option sets decisions are spending time in
+	FName Name;
+
+	// Options, considerations, inputs, target generators and trees from Sources, reported to the garbage collector
+	TArray<UObject*> ReferencedObjects;
+
+	// Get the list for these sets, shared with anyone else using the same sets. Built the first time it's asked for.
+	static TSharedRef<const FAISortedOptionList> Get(TArrayView<const TSharedRef<const FAICompiledOptionSet>> InSources);
+
+	// How many lists are in use, and how much memory they take up
+	static void GetSharedStats(int32& OutNumLists, SIZE_T& OutAllocatedSize);
+
+	bool HasSources(TArrayView<const TSharedRef<const FAICompiledOptionSet>> InSources) const;
+
+	SIZE_T GetAllocatedSize() const;
+
+	// FGCObject
+	virtual void AddReferencedObjects(FReferenceCollector& Collector) override;
+	virtual FString GetReferencerName() const override;
+};
+
+namespace AIOptionRanking
+{
+	// Highest rank first. Within a rank, options keep the order of their sets (which is priority order for a decision maker),
+	// and within a set, options that could score highest go first so they raise the bar for the rest.
+	UTILITYAI_API void SortByRank(TArray<FAIOptionRef>& Options);
+
+	// Index of the first option after Start with a different rank. Options must be sorted by rank.
+	UTILITYAI_API int32 FindRankEnd(TArrayView<const FAIOptionRef> SortedOptions, int32 Start);
+
+	// Score sorted options one rank at a time on this thread, and stop at the first rank that has any options with weight.
+	// OutScores needs a slot for every option, and matches SortedOptions. Returns the best weight, and the winning rank's range in OutRankStart/OutRankNum.
+	UTILITYAI_API float ScoreBestRank(TArrayView<const FAIOptionRef> SortedOptions, const FDecisionMakerContext& Context, float PruneFraction,
+		TArrayView<FAIOptionScore> OutScores, int32& OutRankStart, int32& OutRankNum);
+}
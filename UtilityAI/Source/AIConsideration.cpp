@@ -0,0 +1,53 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "AIConsideration.h"
+
+UAIConsideration::UAIConsideration()
+{
+}
+
+FAIConsiderationScore UAIConsideration::CalculateScore_Implementation(const FDecisionMakerContext& Context)
+{
+	return FAIConsiderationScore();
+}
+
+void UAIConsideration::CalculateScoreBatch(TArrayView<const FDecisionMakerContext> Contexts, TArrayView<FAIConsiderationScore> OutScores)
+{
+	check(Contexts.Num() == OutScores.Num());
+
+	const bool bNative = IsThreadSafe();
+	for (int32 Index = 0; Index < Contexts.Num(); ++Index)
+	{
+		OutScores[Index] = bNative ? CalculateScore_Implementation(Contexts[Index]) : CalculateScore(Contexts[Index]);
+	}
+}
+
+
+FString UAIConsideration::GetConsiderationDescription()
+{
+	FString Output;
+	Output.Append(GetClass()->GetName());
+	if (Description.IsEmpty() == false)
+	{
+		Output.Append(FString(": "));
+		Output.Append(Description);
+	}
+	return Output;
+}
+
+bool UAIConsideration::IsThreadSafe() const
+{
+	// Blueprint subclasses go through the script VM, which has to stay on the game thread
+	return bThreadSafe && GetClass()->HasAnyClassFlags(CLASS_Native);
+}
+
+bool UAIConsideration::GetScoreBounds(FAIConsiderationScore& OutMaxScore) const
+{
+	if (!bHasScoreBounds)
+		return false;
+
+	OutMaxScore.Addend = MaxAddend;
+	OutMaxScore.Multiplier = FMath::Max(MaxMultiplier, 0.f);
+	return true;
+}
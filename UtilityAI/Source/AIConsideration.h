@@ -0,0 +1,69 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/NoExportTypes.h"
+#include "AIShared.h"
+#include "AIConsideration.generated.h"
+
+
+/**
+ * 
+ */
+UCLASS(Abstract, BlueprintType, Blueprintable, DefaultToInstanced, EditInlineNew)
+class UTILITYAI_API UAIConsideration : public UObject
+{
+	GENERATED_BODY()
+public:
+
+	/* Should be something specific about this particular consideration. It will appear in the visual logger beside the score. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Default, meta = (DisplayPriority = "1"))
+	FString Description;
+
+	/** Promise that this consideration never scores above MaxAddend and MaxMultiplier (and never returns a negative multiplier).
+		Lets the decision maker stop scoring options that can't win. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Bounds", AdvancedDisplay)
+	bool bHasScoreBounds = false;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Bounds", AdvancedDisplay, meta = (EditCondition = "bHasScoreBounds"))
+	float MaxAddend = 0.f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Bounds", AdvancedDisplay, meta = (EditCondition = "bHasScoreBounds", ClampMin = "0"))
+	float MaxMultiplier = 1.f;
+
+	/** Reuse this consideration's score for this many seconds, per agent. Good for slowly changing inputs. 0 scores every time. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Caching", AdvancedDisplay, meta = (ClampMin = "0"))
+	float CacheTimeToLive = 0.f;
+
+	/** Considerations with the same key share one cached score per agent. Only share keys between considerations that always score the same. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Caching", AdvancedDisplay, meta = (EditCondition = "CacheTimeToLive > 0"))
+	FName CacheKey;
+
+	/** Doesn't depend on the agent, so agents in a decision group can share one score per group decision */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Caching", AdvancedDisplay)
+	bool bSharedInGroup = false;
+
+	UAIConsideration();
+
+	UFUNCTION(BlueprintNativeEvent)
+	FAIConsiderationScore CalculateScore(const FDecisionMakerContext& Context);
+
+	// Score many contexts (agents, options or targets) in one call. Native subclasses can override this to vectorize.
+	virtual void CalculateScoreBatch(TArrayView<const FDecisionMakerContext> Contexts, TArrayView<FAIConsiderationScore> OutScores);
+
+	// Get a string to describe this consideration
+	virtual FString GetConsiderationDescription();
+
+	// Can CalculateScore run on a worker thread? Only native classes that opt in with bThreadSafe are.
+	virtual bool IsThreadSafe() const;
+
+	// Get the highest addend and multiplier this consideration can return. Returns false if there's no limit.
+	// Native subclasses can override this to work it out from their settings.
+	virtual bool GetScoreBounds(FAIConsiderationScore& OutMaxScore) const;
+
+protected:
+
+	/** Native subclasses set this in their constructor if CalculateScore only reads state that doesn't change during scoring. */
+	bool bThreadSafe = false;
+};
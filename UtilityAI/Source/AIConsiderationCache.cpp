@@ -0,0 +1,81 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "AIConsiderationCache.h"
+#include "AIConsideration.h"
+
+
+FAIConsiderationCacheKey FAIConsiderationCacheKey::Make(const UAIConsideration* InConsideration, FName InCacheKey)
+{
+	FAIConsiderationCacheKey Key;
+	if (InCacheKey.IsNone())
+	{
+		Key.Consideration = FObjectKey(InConsideration);
+	}
+	else
+	{
+		Key.CacheKey = InCacheKey;
+	}
+	return Key;
+}
+
+
+bool FAIConsiderationCache::Find(const FAIConsiderationCacheKey& Key, double CurrentTime, FAIConsiderationScore& OutScore) const
+{
+	FReadScopeLock ReadLock(Lock);
+
+	const FEntry* Entry = Entries.Find(Key);
+	if (!Entry || CurrentTime >= Entry->ExpiryTime)
+		return false;
+
+	OutScore = Entry->Score;
+	return true;
+}
+
+void FAIConsiderationCache::Add(const FAIConsiderationCacheKey& Key, const FAIConsiderationScore& Score, double ExpiryTime)
+{
+	FWriteScopeLock WriteLock(Lock);
+
+	FEntry& Entry = Entries.FindOrAdd(Key);
+	Entry.Score = Score;
+	Entry.ExpiryTime = ExpiryTime;
+}
+
+void FAIConsiderationCache::Invalidate(const UAIConsideration* Consideration)
+{
+	if (!Consideration)
+		return;
+
+	FWriteScopeLock WriteLock(Lock);
+
+	Entries.Remove(FAIConsiderationCacheKey::Make(Consideration, Consideration->CacheKey));
+}
+
+void FAIConsiderationCache::InvalidateKey(FName CacheKey)
+{
+	FWriteScopeLock WriteLock(Lock);
+
+	Entries.Remove(FAIConsiderationCacheKey::Make(nullptr, CacheKey));
+}
+
+void FAIConsiderationCache::Reset()
+{
+	FWriteScopeLock WriteLock(Lock);
+
+	// Keep the memory around, we'll probably fill it up again
+	Entries.Reset();
+}
+
+int32 FAIConsiderationCache::Num() const
+{
+	FReadScopeLock ReadLock(Lock);
+
+	return Entries.Num();
+}
+
+SIZE_T FAIConsiderationCache::GetAllocatedSize() const
+{
+	FReadScopeLock ReadLock(Lock);
+
+	return Entries.GetAllocatedSize();
+}
@@ -0,0 +1,71 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/ObjectKey.h"
+#include "Misc/ScopeRWLock.h"
+#include "AIShared.h"
+
+
+class UAIConsideration;
+
+/** Considerations with a CacheKey share an entry. Otherwise each consideration gets its own. */
+struct FAIConsiderationCacheKey
+{
+	FObjectKey Consideration;
+
+	FName CacheKey;
+
+	static FAIConsiderationCacheKey Make(const UAIConsideration* InConsideration, FName InCacheKey);
+
+	bool operator==(const FAIConsiderationCacheKey& Other) const
+	{
+		return Consideration == Other.Consideration && CacheKey == Other.CacheKey;
+	}
+
+	friend uint32 GetTypeHash(const FAIConsiderationCacheKey& Key)
+	{
+		return HashCombine(GetTypeHash(Key.Consideration), GetTypeHash(Key.CacheKey));
+	}
+};
+
+
+/**
+ * Per-agent store of recent consideration scores, so slowly changing inputs aren't scored again every decision.
+ * Entries expire after the consideration's CacheTimeToLive. Safe to use from scoring worker threads.
+ */
+class UTILITYAI_API FAIConsiderationCache
+{
+public:
+
+	// Get a cached score that hasn't expired yet
+	bool Find(const FAIConsiderationCacheKey& Key, double CurrentTime, FAIConsiderationScore& OutScore) const;
+
+	void Add(const FAIConsiderationCacheKey& Key, const FAIConsiderationScore& Score, double ExpiryTime);
+
+	// Forget one consideration's score (including any it shares through its CacheKey)
+	void Invalidate(const UAIConsideration* Consideration);
+
+	// Forget the score shared by every consideration with this CacheKey
+	void InvalidateKey(FName CacheKey);
+
+	void Reset();
+
+	int32 Num() const;
+
+	SIZE_T GetAllocatedSize() const;
+
+private:
+
+	struct FEntry
+	{
+		FAIConsiderationScore Score;
+
+		double ExpiryTime = 0;
+	};
+
+	mutable FRWLock Lock;
+
+	TMap<FAIConsiderationCacheKey, FEntry> Entries;
+};
@@ -0,0 +1,52 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "AICooldownStore.h"
+#include "AIShared.h"
+
+
+void FAICooldownStore::Start(FName Name, double CurrentTime, float Duration)
+{
+	if (Name.IsNone() || Duration <= 0)
+		return;
+
+	// Starting cooldowns is rare, so it's a good time to forget the ones that have run out
+	Entries.RemoveAllSwap([CurrentTime](const FEntry& Entry)
+	{
+		return Entry.ExpiryTime <= CurrentTime;
+	}, EAllowShrinking::No);
+
+	for (FEntry& Entry : Entries)
+	{
+		if (Entry.Name == Name)
+		{
+			Entry.ExpiryTime = FMath::Max(Entry.ExpiryTime, CurrentTime + Duration);
+			return;
+		}
+	}
+
+	Entries.Add({ Name, CurrentTime + Duration });
+}
+
+void FAICooldownStore::Clear(FName Name)
+{
+	Entries.RemoveAllSwap([Name](const FEntry& Entry)
+	{
+		return Entry.Name == Name;
+	}, EAllowShrinking::No);
+}
+
+void FAICooldownStore::Reset()
+{
+	Entries.Reset();
+}
+
+float FAICooldownStore::GetRemaining(FName Name, double CurrentTime) const
+{
+	for (const FEntry& Entry : Entries)
+	{
+		if (Entry.Name == Name)
+			return FMath::Max(float(Entry.ExpiryTime - CurrentTime), 0.f);
+	}
+	return 0.f;
+}
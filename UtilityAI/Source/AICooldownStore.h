@@ -0,0 +1,62 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+
+/**
+ * When each named cooldown runs out. Options are locked out while the cooldown with their cooldown name is running.
+ * Agents rarely have more than a few cooldowns running, so they're kept inline and searched linearly. That keeps the store
+ * free of heap allocations for most agents. Safe to read from scoring worker threads, as long as nothing is started meanwhile.
+ */
+struct UTILITYAI_API FAICooldownStore
+{
+	// Start a cooldown, or extend one that's already running. A cooldown is never shortened this way.
+	void Start(FName Name, double CurrentTime, float Duration);
+
+	void Clear(FName Name);
+
+	void Reset();
+
+	bool IsActive(FName Name, double CurrentTime) const
+	{
+		for (const FEntry& Entry : Entries)
+		{
+			if (Entry.Name == Name)
+				return Entry.ExpiryTime > CurrentTime;
+		}
+		return false;
+	}
+
+	// Seconds until the cooldown runs out. 0 if it isn't running.
+	float GetRemaining(FName Name, double CurrentTime) const;
+
+	// Call Function(Name, SecondsRemaining) for each cooldown that's still running
+	template<typename FunctionType>
+	void ForEachActive(double CurrentTime, FunctionType&& Function) const
+	{
+		for (const FEntry& Entry : Entries)
+		{
+			if (Entry.ExpiryTime > CurrentTime)
+			{
+				Function(Entry.Name, float(Entry.ExpiryTime - CurrentTime));
+			}
+		}
+	}
+
+	int32 Num() const { return Entries.Num(); }
+
+	SIZE_T GetAllocatedSize() const { return Entries.GetAllocatedSize(); }
+
+private:
+
+	struct FEntry
+	{
+		FName Name;
+
+		double ExpiryTime = 0;
+	};
+
+	TArray<FEntry, TInlineAllocator<4>> Entries;
+};
@@ -0,0 +1,173 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "AIDecisionGroup.h"
+#include "DecisionMakerComponent.h"
+#include "AIOption.h"
+#include "UtilityAIStats.h"
+
+
+FAIDecisionGroup::FAIDecisionGroup(FName InName)
+	: Name(InName)
+{
+}
+
+void FAIDecisionGroup::AddMember(UDecisionMakerComponent* DecisionMaker)
+{
+	if (!DecisionMaker || DecisionMaker->DecisionGroup == this)
+		return;
+
+	Members.Add(DecisionMaker);
+	DecisionMaker->DecisionGroup = this;
+}
+
+void FAIDecisionGroup::RemoveMember(UDecisionMakerComponent* DecisionMaker)
+{
+	if (!DecisionMaker || DecisionMaker->DecisionGroup != this)
+		return;
+
+	Members.Remove(DecisionMaker);
+	DecisionMaker->DecisionGroup = nullptr;
+
+	// Let someone else have its exclusive option
+	for (auto It = Claims.CreateIterator(); It; ++It)
+	{
+		if (It.Value() == DecisionMaker)
+		{
+			It.RemoveCurrent();
+		}
+	}
+}
+
+void FAIDecisionGroup::RemoveAllMembers()
+{
+	for (const TWeakObjectPtr<UDecisionMakerComponent>& Member : Members)
+	{
+		if (UDecisionMakerComponent* DecisionMaker = Member.Get())
+		{
+			DecisionMaker->DecisionGroup = nullptr;
+		}
+	}
+
+	Members.Reset();
+	Claims.Reset();
+}
+
+void FAIDecisionGroup::RunDecisions(double CurrentTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_UtilityAI_GroupDecisions);
+
+	Members.RemoveAll([](const TWeakObjectPtr<UDecisionMakerComponent>& Member)
+	{
+		return !Member.IsValid();
+	});
+
+	{
+		FWriteScopeLock WriteLock(SharedScoresLock);
+		SharedScores.Reset();
+	}
+
+	// Start from what everyone is running, so claims of members that have gone are dropped
+	Claims.Reset();
+	Bidders.Reset();
+	for (const TWeakObjectPtr<UDecisionMakerComponent>& Member : Members)
+	{
+		UDecisionMakerComponent* DecisionMaker = Member.Get();
+		UpdateClaims(DecisionMaker);
+
+		if (DecisionMaker->bIsRunning && !DecisionMaker->bIsPaused)
+		{
+			Bidders.Add(DecisionMaker);
+		}
+	}
+
+	// Everyone bids with their best weight. Shared considerations are only scored by the first member to need them.
+	for (UDecisionMakerComponent* Bidder : Bidders)
+	{
+		Bidder->ScoreDecision();
+	}
+
+	// Highest bids pick first
+	Bidders.StableSort([](const UDecisionMakerComponent& A, const UDecisionMakerComponent& B)
+	{
+		return A.ScoredBestWeight > B.ScoredBestWeight;
+	});
+
+	for (UDecisionMakerComponent* Bidder : Bidders)
+	{
+		// Deciding can have side effects, including members leaving
+		if (!IsValid(Bidder) || Bidder->DecisionGroup != this)
+			continue;
+
+		// An option this member was counting on has been taken by a higher bidder, so score again without it
+		if (HasScoredClaimedOption(Bidder))
+		{
+			INC_DWORD_STAT(STAT_UtilityAI_GroupRescores);
+			Bidder->ScoreDecision();
+		}
+
+		Bidder->ApplyDecision();
+		Bidder->ScheduleNextDecision(CurrentTime);
+
+		UpdateClaims(Bidder);
+	}
+}
+
+bool FAIDecisionGroup::FindSharedScore(const UAIConsideration* Consideration, FAIConsiderationScore& OutScore) const
+{
+	FReadScopeLock ReadLock(SharedScoresLock);
+
+	if (const FAIConsiderationScore* Score = SharedScores.Find(Consideration))
+	{
+		OutScore = *Score;
+		return true;
+	}
+	return false;
+}
+
+void FAIDecisionGroup::AddSharedScore(const UAIConsideration* Consideration, const FAIConsiderationScore& Score)
+{
+	// Two members might score it at once. They'll get the same score anyway.
+	FWriteScopeLock WriteLock(SharedScoresLock);
+	SharedScores.Add(Consideration, Score);
+}
+
+bool FAIDecisionGroup::IsClaimedByOther(FName OptionName, const UDecisionMakerComponent* DecisionMaker) const
+{
+	UDecisionMakerComponent* const* Claimant = Claims.Find(OptionName);
+	return Claimant && *Claimant != DecisionMaker;
+}
+
+UDecisionMakerComponent* FAIDecisionGroup::GetClaimant(FName OptionName) const
+{
+	UDecisionMakerComponent* const* Claimant = Claims.Find(OptionName);
+	return Claimant ? *Claimant : nullptr;
+}
+
+bool FAIDecisionGroup::HasScoredClaimedOption(const UDecisionMakerComponent* DecisionMaker) const
+{
+	for (const FAIOptionScore& OptionScore : DecisionMaker->ScoredOptions)
+	{
+		if (OptionScore.Weight > 0 && OptionScore.Option && OptionScore.Option->bExclusiveInGroup && IsClaimedByOther(OptionScore.Option->OptionName, DecisionMaker))
+			return true;
+	}
+	return false;
+}
+
+void FAIDecisionGroup::UpdateClaims(UDecisionMakerComponent* DecisionMaker)
+{
+	for (auto It = Claims.CreateIterator(); It; ++It)
+	{
+		if (It.Value() == DecisionMaker)
+		{
+			It.RemoveCurrent();
+		}
+	}
+
+	// If two members already hold the same option (eg. one just joined), the first one keeps it
+	const UAIOption* CurrentOption = DecisionMaker->GetCurrentOption();
+	if (CurrentOption && CurrentOption->bExclusiveInGroup && !Claims.Contains(CurrentOption->OptionName))
+	{
+		Claims.Add(CurrentOption->OptionName, DecisionMaker);
+	}
+}
@@ -0,0 +1,70 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AIShared.h"
+
+
+class UDecisionMakerComponent;
+class UAIConsideration;
+
+/**
+ * Decision makers that decide together, eg. a squad. When any member is due, every member decides in the same pass:
+ * - Considerations marked bSharedInGroup don't depend on the agent, so they're scored once and the score is handed to every member.
+ * - Options marked bExclusiveInGroup are run by one member at a time. Members are assigned in a greedy auction:
+ *   everyone scores, then the member with the highest bid picks first, and anyone who scored an option that's since been taken scores again without it.
+ * Members keep their exclusive option until they pick something else.
+ * Created and owned by the UtilityAISubsystem, from each decision maker's DecisionGroupName.
+ */
+class UTILITYAI_API FAIDecisionGroup
+{
+public:
+
+	explicit FAIDecisionGroup(FName InName);
+
+	FName GetName() const { return Name; }
+
+	void AddMember(UDecisionMakerComponent* DecisionMaker);
+	void RemoveMember(UDecisionMakerComponent* DecisionMaker);
+
+	// Remove every member, eg. when the world goes away
+	void RemoveAllMembers();
+
+	int32 Num() const { return Members.Num(); }
+
+	// Score and apply every member's decision, then schedule their next ones
+	void RunDecisions(double CurrentTime);
+
+	// Shared scores are only kept for one RunDecisions. Safe to call from scoring worker threads.
+	bool FindSharedScore(const UAIConsideration* Consideration, FAIConsiderationScore& OutScore) const;
+	void AddSharedScore(const UAIConsideration* Consideration, const FAIConsiderationScore& Score);
+
+	// Is an exclusive option held by a member other than DecisionMaker?
+	bool IsClaimedByOther(FName OptionName, const UDecisionMakerComponent* DecisionMaker) const;
+
+	// The member holding an exclusive option, if any
+	UDecisionMakerComponent* GetClaimant(FName OptionName) const;
+
+private:
+
+	// Did DecisionMaker's last scoring give weight to an option someone else has claimed since?
+	bool HasScoredClaimedOption(const UDecisionMakerComponent* DecisionMaker) const;
+
+	// Release DecisionMaker's claims, and claim its current option if it's exclusive
+	void UpdateClaims(UDecisionMakerComponent* DecisionMaker);
+
+	FName Name;
+
+	TArray<TWeakObjectPtr<UDecisionMakerComponent>> Members;
+
+	// Exclusive option names, and the member holding each one. Only changed on the game thread between members' scoring.
+	TMap<FName, UDecisionMakerComponent*> Claims;
+
+	mutable FRWLock SharedScoresLock;
+
+	TMap<const UAIConsideration*, FAIConsiderationScore> SharedScores;
+
+	// Members deciding in this pass, highest bid first. Kept so a pass doesn't need to allocate.
+	TArray<UDecisionMakerComponent*> Bidders;
+};
@@ -0,0 +1,516 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "AIDecisionRecording.h"
+#include "AIOption.h"
+#include "AIOptionSetDataAsset.h"
+#include "Serialization/MemoryWriter.h"
+#include "Serialization/MemoryReader.h"
+#include "Misc/FileHelper.h"
+
+
+namespace AIDecisionRecording
+{
+	static constexpr uint32 Magic = 0x52494155; // UAIR
+	static constexpr int32 Version = 3;
+
+	enum class EChunk : uint8
+	{
+		OptionSetPath,
+		Decision
+	};
+}
+
+
+FAIDecisionRecorder::FAIDecisionRecorder(const FString& AgentName, const FAIOptionSelector& Selector)
+{
+	FMemoryWriter Writer(Data, true);
+
+	uint32 Magic = AIDecisionRecording::Magic;
+	int32 Version = AIDecisionRecording::Version;
+	FString Name = AgentName;
+	uint8 Strategy = static_cast<uint8>(Selector.Strategy);
+	float MinimumWeightFraction = Selector.MinimumWeightFraction;
+	float SoftmaxTemperature = Selector.SoftmaxTemperature;
+
+	Writer << Magic << Version << Name << Strategy << MinimumWeightFraction << SoftmaxTemperature;
+}
+
+void FAIDecisionRecorder::BeginDecision(double Time, TArrayView<const TSharedRef<const FAICompiledOptionSet>> OptionSets)
+{
+	FScopeLock ScopeLock(&Lock);
+
+	FrameTime = Time;
+	FrameOptionSets = OptionSets;
+	FrameScores.Reset();
+	FrameInputs.Reset();
+	FrameTargets.Reset();
+	FrameCooldowns.Reset();
+	FrameClaims.Reset();
+}
+
+void FAIDecisionRecorder::RecordScore(const UAIConsideration* Consideration, int32 TargetIndex, const FAIConsiderationScore& Score)
+{
+	FScopeLock ScopeLock(&Lock);
+	FrameScores.Add(MakeTuple(Consideration, TargetIndex), Score);
+}
+
+void FAIDecisionRecorder::RecordInput(const UAIConsideration* Consideration, int32 TargetIndex, float RawInput)
+{
+	FScopeLock ScopeLock(&Lock);
+	FrameInputs.Add(MakeTuple(Consideration, TargetIndex), RawInput);
+}
+
+void FAIDecisionRecorder::RecordTargets(const UAIOption* Option, int32 NumTargets)
+{
+	FScopeLock ScopeLock(&Lock);
+	FrameTargets.Add(Option, NumTargets);
+}
+
+void FAIDecisionRecorder::RecordCooldown(FName CooldownName)
+{
+	FScopeLock ScopeLock(&Lock);
+	FrameCooldowns.AddUnique(CooldownName);
+}
+
+void FAIDecisionRecorder::RecordClaim(FName OptionName)
+{
+	FScopeLock ScopeLock(&Lock);
+	FrameClaims.AddUnique(OptionName);
+}
+
+int32 FAIDecisionRecorder::GetPathIndex(const FSoftObjectPath& Path)
+{
+	if (const int32* Index = PathIndices.Find(Path))
+		return *Index;
+
+	// Paths are written the first time they're used, so the stream can be read front to back
+	FMemoryWriter Writer(Data, true, true);
+
+	uint8 Chunk = static_cast<uint8>(AIDecisionRecording::EChunk::OptionSetPath);
+	FString PathString = Path.ToString();
+	Writer << Chunk << PathString;
+
+	return PathIndices.Add(Path, PathIndices.Num());
+}
+
+void FAIDecisionRecorder::EndDecision(int32 RandomSeed, const UAIOption* SelectedOption, float SelectedWeight)
+{
+	FScopeLock ScopeLock(&Lock);
+
+	FrameRandomSeed = RandomSeed;
+
+	TArray<int32, TInlineAllocator<8>> PathIndicesForFrame;
+	for (const TSharedRef<const FAICompiledOptionSet>& OptionSet : FrameOptionSets)
+	{
+		PathIndicesForFrame.Add(GetPathIndex(OptionSet->SourcePath));
+	}
+
+	// Pointers mean nothing outside this run, so identify considerations and options by where they are in their compiled set
+	TMap<const UAIConsideration*, TTuple<uint16, uint16>> ConsiderationLocations;
+	TMap<const UAIOption*, TTuple<uint16, uint16>> OptionLocations;
+	for (int32 SetIndex = 0; SetIndex < FrameOptionSets.Num() && SetIndex <= MAX_uint16; ++SetIndex)
+	{
+		const FAICompiledOptionSet& OptionSet = *FrameOptionSets[SetIndex];
+		for (int32 Index = 0; Index < OptionSet.Considerations.Num() && Index <= MAX_uint16; ++Index)
+		{
+			ConsiderationLocations.Add(OptionSet.Considerations[Index].Consideration, MakeTuple(static_cast<uint16>(SetIndex), static_cast<uint16>(Index)));
+		}
+		for (int32 Index = 0; Index < OptionSet.Num() && Index <= MAX_uint16; ++Index)
+		{
+			OptionLocations.Add(OptionSet.Options[Index], MakeTuple(static_cast<uint16>(SetIndex), static_cast<uint16>(Index)));
+		}
+	}
+
+	TMap<TTuple<const UAIConsideration*, int32>, FAIRecordedConsideration> Recorded;
+	auto FindOrAddEntry = [&](const TTuple<const UAIConsideration*, int32>& Key) -> FAIRecordedConsideration*
+	{
+		if (FAIRecordedConsideration* Entry = Recorded.Find(Key))
+			return Entry;
+
+		const TTuple<uint16, uint16>* Location = ConsiderationLocations.Find(Key.Get<0>());
+		if (!Location)
+			return nullptr;
+
+		FAIRecordedConsideration& Entry = Recorded.Add(Key);
+		Entry.OptionSet = Location->Get<0>();
+		Entry.Consideration = Location->Get<1>();
+		Entry.TargetIndex = Key.Get<1>();
+		return &Entry;
+	};
+
+	for (const TPair<TTuple<const UAIConsideration*, int32>, FAIConsiderationScore>& Score : FrameScores)
+	{
+		if (FAIRecordedConsideration* Entry = FindOrAddEntry(Score.Key))
+		{
+			Entry->Score = Score.Value;
+		}
+	}
+
+	for (const TPair<TTuple<const UAIConsideration*, int32>, float>& RawInput : FrameInputs)
+	{
+		if (FAIRecordedConsideration* Entry = FindOrAddEntry(RawInput.Key))
+		{
+			Entry->bHasInput = true;
+			Entry->RawInput = RawInput.Value;
+		}
+	}
+
+	TArray<FAIRecordedTargets> RecordedTargets;
+	for (const TPair<const UAIOption*, int32>& Targets : FrameTargets)
+	{
+		if (const TTuple<uint16, uint16>* Location = OptionLocations.Find(Targets.Key))
+		{
+			RecordedTargets.Add({ Location->Get<0>(), Location->Get<1>(), Targets.Value });
+		}
+	}
+
+	FMemoryWriter Writer(Data, true, true);
+
+	uint8 Chunk = static_cast<uint8>(AIDecisionRecording::EChunk::Decision);
+	Writer << Chunk << FrameTime << FrameRandomSeed;
+
+	int32 NumOptionSets = PathIndicesForFrame.Num();
+	Writer << NumOptionSets;
+	for (int32& PathIndex : PathIndicesForFrame)
+	{
+		Writer << PathIndex;
+	}
+
+	int32 NumConsiderations = Recorded.Num();
+	Writer << NumConsiderations;
+	for (TPair<TTuple<const UAIConsideration*, int32>, FAIRecordedConsideration>& Pair : Recorded)
+	{
+		FAIRecordedConsideration& Entry = Pair.Value;
+		uint8 bHasInput = Entry.bHasInput ? 1 : 0;
+		Writer << Entry.OptionSet << Entry.Consideration << Entry.TargetIndex << Entry.Score.Addend << Entry.Score.Multiplier << bHasInput;
+		if (bHasInput)
+		{
+			Writer << Entry.RawInput;
+		}
+	}
+
+	int32 NumTargetedOptions = RecordedTargets.Num();
+	Writer << NumTargetedOptions;
+	for (FAIRecordedTargets& Entry : RecordedTargets)
+	{
+		Writer << Entry.OptionSet << Entry.Option << Entry.NumTargets;
+	}
+
+	int32 NumCooldowns = FrameCooldowns.Num();
+	Writer << NumCooldowns;
+	for (const FName& CooldownName : FrameCooldowns)
+	{
+		FString CooldownString = CooldownName.ToString();
+		Writer << CooldownString;
+	}
+
+	int32 NumClaims = FrameClaims.Num();
+	Writer << NumClaims;
+	for (const FName& OptionName : FrameClaims)
+	{
+		FString OptionString = OptionName.ToString();
+		Writer << OptionString;
+	}
+
+	FString SelectedOptionName = SelectedOption ? SelectedOption->OptionName.ToString() : FString();
+	Writer << SelectedOptionName << SelectedWeight;
+
+	FrameOptionSets.Reset();
+	++NumDecisions;
+}
+
+bool FAIDecisionRecorder::SaveToFile(const FString& Filename) const
+{
+	return FFileHelper::SaveArrayToFile(Data, *Filename);
+}
+
+
+bool FAIDecisionReplayFrame::FindScore(const UAIConsideration* Consideration, int32 TargetIndex, FAIConsiderationScore& OutScore) const
+{
+	const FAIRecordedConsideration* const* Recorded = BoundConsiderations.Find(MakeTuple(Consideration, TargetIndex));
+	if (!Recorded)
+		return false;
+
+	OutScore = (*Recorded)->Score;
+	return true;
+}
+
+bool FAIDecisionReplayFrame::FindInput(const UAIConsideration* Consideration, int32 TargetIndex, float& OutRawInput) const
+{
+	const FAIRecordedConsideration* const* Recorded = BoundConsiderations.Find(MakeTuple(Consideration, TargetIndex));
+	if (!Recorded || !(*Recorded)->bHasInput)
+		return false;
+
+	OutRawInput = (*Recorded)->RawInput;
+	return true;
+}
+
+int32 FAIDecisionReplayFrame::GetNumTargets(const UAIOption* Option) const
+{
+	const int32* NumTargets = BoundTargets.Find(Option);
+	return NumTargets ? *NumTargets : 0;
+}
+
+void FAIDecisionReplayFrame::Bind(TArrayView<const TSharedRef<const FAICompiledOptionSet>> CompiledOptionSets)
+{
+	BoundConsiderations.Reset();
+	BoundTargets.Reset();
+
+	for (const FAIRecordedConsideration& Recorded : Considerations)
+	{
+		if (!CompiledOptionSets.IsValidIndex(Recorded.OptionSet))
+			continue;
+
+		const TArray<FAICompiledConsideration>& CompiledConsiderations = CompiledOptionSets[Recorded.OptionSet]->Considerations;
+		if (CompiledConsiderations.IsValidIndex(Recorded.Consideration))
+		{
+			const UAIConsideration* Consideration = CompiledConsiderations[Recorded.Consideration].Consideration;
+			BoundConsiderations.Add(MakeTuple(Consideration, Recorded.TargetIndex), &Recorded);
+		}
+	}
+
+	for (const FAIRecordedTargets& Recorded : Targets)
+	{
+		if (!CompiledOptionSets.IsValidIndex(Recorded.OptionSet))
+			continue;
+
+		const TArray<UAIOption*>& Options = CompiledOptionSets[Recorded.OptionSet]->Options;
+		if (Options.IsValidIndex(Recorded.Option))
+		{
+			BoundTargets.Add(Options[Recorded.Option], Recorded.NumTargets);
+		}
+	}
+}
+
+
+bool FAIDecisionReplayer::LoadFromFile(const FString& Filename)
+{
+	TArray<uint8> FileData;
+	if (!FFileHelper::LoadFileToArray(FileData, *Filename))
+		return false;
+
+	return LoadFromData(FileData);
+}
+
+bool FAIDecisionReplayer::LoadFromData(TArrayView<const uint8> InData)
+{
+	OptionSetPaths.Reset();
+	Frames.Reset();
+
+	FMemoryReaderView Reader(InData, true);
+
+	uint32 Magic = 0;
+	int32 Version = 0;
+	uint8 Strategy = 0;
+	Reader << Magic << Version;
+	if (Magic != AIDecisionRecording::Magic || Version != AIDecisionRecording::Version)
+	{
+		UE_LOG(LogDM, Warning, TEXT("Not a decision recording, or recorded with a different version"));
+		return false;
+	}
+
+	Reader << AgentName << Strategy << Selector.MinimumWeightFraction << Selector.SoftmaxTemperature;
+	Selector.Strategy = static_cast<EAIOptionSelectionStrategy>(Strategy);
+
+	while (!Reader.AtEnd() && !Reader.IsError())
+	{
+		uint8 Chunk = 0;
+		Reader << Chunk;
+
+		if (Chunk == static_cast<uint8>(AIDecisionRecording::EChunk::OptionSetPath))
+		{
+			FString PathString;
+			Reader << PathString;
+			OptionSetPaths.Add(FSoftObjectPath(PathString));
+		}
+		else if (Chunk == static_cast<uint8>(AIDecisionRecording::EChunk::Decision))
+		{
+			FAIDecisionReplayFrame& Frame = Frames.AddDefaulted_GetRef();
+			Reader << Frame.Time << Frame.RandomSeed;
+
+			int32 NumOptionSets = 0;
+			Reader << NumOptionSets;
+			for (int32 Index = 0; Index < NumOptionSets && !Reader.IsError(); ++Index)
+			{
+				Reader << Frame.OptionSets.AddDefaulted_GetRef();
+			}
+
+			int32 NumConsiderations = 0;
+			Reader << NumConsiderations;
+			for (int32 Index = 0; Index < NumConsiderations && !Reader.IsError(); ++Index)
+			{
+				FAIRecordedConsideration& Entry = Frame.Considerations.AddDefaulted_GetRef();
+				uint8 bHasInput = 0;
+				Reader << Entry.OptionSet << Entry.Consideration << Entry.TargetIndex << Entry.Score.Addend << Entry.Score.Multiplier << bHasInput;
+				Entry.bHasInput = bHasInput != 0;
+				if (Entry.bHasInput)
+				{
+					Reader << Entry.RawInput;
+				}
+			}
+
+			int32 NumTargetedOptions = 0;
+			Reader << NumTargetedOptions;
+			for (int32 Index = 0; Index < NumTargetedOptions && !Reader.IsError(); ++Index)
+			{
+				FAIRecordedTargets& Entry = Frame.Targets.AddDefaulted_GetRef();
+				Reader << Entry.OptionSet << Entry.Option << Entry.NumTargets;
+			}
+
+			int32 NumCooldowns = 0;
+			Reader << NumCooldowns;
+			for (int32 Index = 0; Index < NumCooldowns && !Reader.IsError(); ++Index)
+			{
+				FString CooldownName;
+				Reader << CooldownName;
+				Frame.Cooldowns.Start(*CooldownName, Frame.Time, TNumericLimits<float>::Max());
+			}
+
+			int32 NumClaims = 0;
+			Reader << NumClaims;
+			for (int32 Index = 0; Index < NumClaims && !Reader.IsError(); ++Index)
+			{
+				FString OptionName;
+				Reader << OptionName;
+				Frame.ClaimedOptions.Add(*OptionName);
+			}
+
+			FString SelectedOptionName;
+			Reader << SelectedOptionName << Frame.SelectedWeight;
+			Frame.SelectedOptionName = *SelectedOptionName;
+		}
+		else
+		{
+			Reader.SetError();
+		}
+	}
+
+	if (Reader.IsError())
+	{
+		UE_LOG(LogDM, Warning, TEXT("Decision recording for %s is corrupt"), *AgentName);
+		Frames.Reset();
+		return false;
+	}
+
+	return true;
+}
+
+FAIDecisionReplayResult FAIDecisionReplayer::Replay(int32 NumRepeats)
+{
+	FAIDecisionReplayResult Result;
+
+	// Load and compile everything before we start timing
+	TArray<UAIOptionSetDataAsset*> OptionSetAssets;
+	for (const FSoftObjectPath& Path : OptionSetPaths)
+	{
+		UAIOptionSetDataAsset* OptionSet = Cast<UAIOptionSetDataAsset>(Path.TryLoad());
+		if (!OptionSet)
+		{
+			UE_LOG(LogDM, Warning, TEXT("Can't load option set %s. Decisions that used it won't be replayed."), *Path.ToString());
+		}
+		OptionSetAssets.Add(OptionSet);
+	}
+
+	struct FPreparedFrame
+	{
+		FAIDecisionReplayFrame* Frame = nullptr;
+		TArray<TSharedRef<const FAICompiledOptionSet>> CompiledOptionSets;
+	};
+
+	TArray<FPreparedFrame> PreparedFrames;
+	for (FAIDecisionReplayFrame& Frame : Frames)
+	{
+		FPreparedFrame Prepared;
+		Prepared.Frame = &Frame;
+
+		bool bLoaded = true;
+		for (int32 PathIndex : Frame.OptionSets)
+		{
+			UAIOptionSetDataAsset* OptionSet = OptionSetAssets.IsValidIndex(PathIndex) ? OptionSetAssets[PathIndex] : nullptr;
+			if (!OptionSet)
+			{
+				bLoaded = false;
+				break;
+			}
+			Prepared.CompiledOptionSets.Add(OptionSet->GetCompiledOptionSet());
+		}
+
+		if (bLoaded)
+		{
+			Frame.Bind(Prepared.CompiledOptionSets);
+			PreparedFrames.Add(MoveTemp(Prepared));
+		}
+	}
+
+	TArray<FAIOptionRef> SortedOptions;
+	TArray<FAIOptionScore> Scores;
+	TArray<TSharedRef<const FAICompiledOptionSet>> SortedOptionSets;
+	const float PruneFraction = Selector.GetPruneFraction();
+
+	const double StartSeconds = FPlatformTime::Seconds();
+
+	for (int32 Repeat = 0; Repeat < NumRepeats; ++Repeat)
+	{
+		for (const FPreparedFrame& Prepared : PreparedFrames)
+		{
+			// Like the decision maker, only sort again when the option sets change
+			if (Prepared.CompiledOptionSets != SortedOptionSets)
+			{
+				SortedOptions.Reset();
+				for (const TSharedRef<const FAICompiledOptionSet>& CompiledOptionSet : Prepared.CompiledOptionSets)
+				{
+					for (int32 OptionIndex = 0; OptionIndex < CompiledOptionSet->Num(); ++OptionIndex)
+					{
+						SortedOptions.Add({ &CompiledOptionSet.Get(), OptionIndex });
+					}
+				}
+				AIOptionRanking::SortByRank(SortedOptions);
+				SortedOptionSets = Prepared.CompiledOptionSets;
+			}
+
+			FDecisionMakerContext Context;
+			Context.CurrentTime = Prepared.Frame->Time;
+			Context.ReplayFrame = Prepared.Frame;
+			Context.Cooldowns = &Prepared.Frame->Cooldowns;
+
+			Scores.SetNum(SortedOptions.Num(), EAllowShrinking::No);
+			int32 RankStart = 0;
+			int32 RankNum = 0;
+			const float BestWeight = AIOptionRanking::ScoreBestRank(SortedOptions, Context, PruneFraction, Scores, RankStart, RankNum);
+
+			FRandomStream RandomStream(Prepared.Frame->RandomSeed);
+			const TArrayView<const FAIOptionScore> RankScores = MakeArrayView(Scores.GetData() + RankStart, RankNum);
+			const int32 SelectedIndex = Selector.Select(RankScores, BestWeight, RandomStream);
+
+			const FName SelectedOptionName = RankScores.IsValidIndex(SelectedIndex) && RankScores[SelectedIndex].Option
+				? RankScores[SelectedIndex].Option->OptionName
+				: NAME_None;
+
+			if (SelectedOptionName != Prepared.Frame->SelectedOptionName)
+			{
+				++Result.NumMismatches;
+			}
+			++Result.NumDecisions;
+
+			// Every repeat misses the same scores, so only report them once
+			TArray<const UAIConsideration*>& MissingScores = Prepared.Frame->MissingScores;
+			if (MissingScores.Num() > 0)
+			{
+				if (Repeat == 0)
+				{
+					++Result.NumIncomplete;
+					for (const UAIConsideration* Consideration : MissingScores)
+					{
+						UE_LOG(LogDM, Error, TEXT("%s: the decision at %.2f s needs a score for %s, which wasn't recorded"),
+							*AgentName, Prepared.Frame->Time, *GetPathNameSafe(Consideration));
+					}
+				}
+				MissingScores.Reset();
+			}
+		}
+	}
+
+	Result.Seconds = FPlatformTime::Seconds() - StartSeconds;
+	return Result;
+}
@@ -0,0 +1,209 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AIShared.h"
+#include "AIOptionSelector.h"
+#include "AICompiledOptionSet.h"
+#include "AICooldownStore.h"
+
+
+class UAIOption;
+class UAIConsideration;
+
+/**
+ * Writes what one agent's decisions were based on to a compact binary stream: the option sets, every consideration score
+ * (per target, for targeted options), the raw inputs of considerations that have them, how many targets each targeted option had,
+ * the cooldowns and group claims that skipped options, the selection random seed and the option that was picked.
+ * Scoring doesn't stop early while recording, and ranks below the winning one are scored too, so the stream has everything a replay could ask for.
+ * Scores can be recorded from scoring worker threads.
+ */
+class UTILITYAI_API FAIDecisionRecorder
+{
+public:
+
+	FAIDecisionRecorder(const FString& AgentName, const FAIOptionSelector& Selector);
+
+	void BeginDecision(double Time, TArrayView<const TSharedRef<const FAICompiledOptionSet>> OptionSets);
+
+	// TargetIndex is the context's TargetIndex, INDEX_NONE for options without targets
+	void RecordScore(const UAIConsideration* Consideration, int32 TargetIndex, const FAIConsiderationScore& Score);
+
+	void RecordInput(const UAIConsideration* Consideration, int32 TargetIndex, float RawInput);
+
+	// A targeted option's generator came up with this many targets
+	void RecordTargets(const UAIOption* Option, int32 NumTargets);
+
+	// An option was skipped because this cooldown was running
+	void RecordCooldown(FName CooldownName);
+
+	// An exclusive option was skipped because another member of the decision group had it
+	void RecordClaim(FName OptionName);
+
+	// RandomSeed is the selection stream's seed just before selecting. SelectedOption is the selector's pick, before any option commitment.
+	void EndDecision(int32 RandomSeed, const UAIOption* SelectedOption, float SelectedWeight);
+
+	int32 GetNumDecisions() const { return NumDecisions; }
+
+	const TArray<uint8>& GetData() const { return Data; }
+
+	bool SaveToFile(const FString& Filename) const;
+
+private:
+
+	int32 GetPathIndex(const FSoftObjectPath& Path);
+
+	FCriticalSection Lock;
+
+	TArray<uint8> Data;
+
+	TMap<FSoftObjectPath, int32> PathIndices;
+
+	int32 NumDecisions = 0;
+
+	// --- Decision being recorded ---
+
+	double FrameTime = 0;
+
+	int32 FrameRandomSeed = 0;
+
+	TArray<TSharedRef<const FAICompiledOptionSet>> FrameOptionSets;
+
+	TMap<TTuple<const UAIConsideration*, int32>, FAIConsiderationScore> FrameScores;
+
+	TMap<TTuple<const UAIConsideration*, int32>, float> FrameInputs;
+
+	TMap<const UAIOption*, int32> FrameTargets;
+
+	TArray<FName> FrameCooldowns;
+
+	TArray<FName> FrameClaims;
+};
+
+
+/** One recorded consideration, identified by its option set (an index into the frame's OptionSets) and its index in the compiled set */
+struct FAIRecordedConsideration
+{
+	uint16 OptionSet = 0;
+
+	uint16 Consideration = 0;
+
+	// Which target the score is for, INDEX_NONE for options without targets
+	int32 TargetIndex = INDEX_NONE;
+
+	FAIConsiderationScore Score;
+
+	bool bHasInput = false;
+
+	float RawInput = 0.f;
+};
+
+/** How many targets a targeted option had, identified like FAIRecordedConsideration */
+struct FAIRecordedTargets
+{
+	uint16 OptionSet = 0;
+
+	uint16 Option = 0;
+
+	int32 NumTargets = 0;
+};
+
+/** One recorded decision. While it's being replayed, its considerations can be looked up by the loaded objects. */
+struct UTILITYAI_API FAIDecisionReplayFrame
+{
+	double Time = 0;
+
+	int32 RandomSeed = 0;
+
+	// Indices into the recording's option set paths
+	TArray<int32> OptionSets;
+
+	TArray<FAIRecordedConsideration> Considerations;
+
+	TArray<FAIRecordedTargets> Targets;
+
+	// Cooldowns that were running. Replays keep them running for the whole decision.
+	FAICooldownStore Cooldowns;
+
+	// Exclusive options another group member had
+	TArray<FName> ClaimedOptions;
+
+	FName SelectedOptionName;
+
+	float SelectedWeight = 0.f;
+
+	bool FindScore(const UAIConsideration* Consideration, int32 TargetIndex, FAIConsiderationScore& OutScore) const;
+
+	bool FindInput(const UAIConsideration* Consideration, int32 TargetIndex, float& OutRawInput) const;
+
+	// Replays have no actors to target, so targeted options are scored for this many targets by index
+	int32 GetNumTargets(const UAIOption* Option) const;
+
+	bool IsClaimed(FName OptionName) const { return ClaimedOptions.Contains(OptionName); }
+
+	// Scoring needed a consideration the recording has no score for. The replayer reports these after each decision.
+	void ReportMissingScore(const UAIConsideration* Consideration) const { MissingScores.AddUnique(Consideration); }
+
+	// Point the lookups at the compiled sets being replayed. They must match OptionSets.
+	void Bind(TArrayView<const TSharedRef<const FAICompiledOptionSet>> CompiledOptionSets);
+
+private:
+
+	friend class FAIDecisionReplayer;
+
+	TMap<TTuple<const UAIConsideration*, int32>, const FAIRecordedConsideration*> BoundConsiderations;
+
+	TMap<const UAIOption*, int32> BoundTargets;
+
+	// Replays score on one thread, so this doesn't need a lock
+	mutable TArray<const UAIConsideration*> MissingScores;
+};
+
+struct FAIDecisionReplayResult
+{
+	int32 NumDecisions = 0;
+
+	// Decisions where the replay picked a different option to the recording
+	int32 NumMismatches = 0;
+
+	// Decisions that needed a score the recording doesn't have. They can't be replayed faithfully.
+	int32 NumIncomplete = 0;
+
+	double Seconds = 0;
+};
+
+/**
+ * Plays a recording back through the compiled option sets and the selector, without a world.
+ * Considerations get their recorded scores back, except ones with a recorded raw input (like response curves), which score it again.
+ * That way changes to curves and to the scoring loop can be profiled and compared against real traces.
+ * Live considerations are never called, since there's no world to score against. A consideration the recording has no score for
+ * gets a multiplier of 0 and is logged as an error, and the decision counts as incomplete.
+ */
+class UTILITYAI_API FAIDecisionReplayer
+{
+public:
+
+	bool LoadFromFile(const FString& Filename);
+
+	bool LoadFromData(TArrayView<const uint8> InData);
+
+	// Replay every decision NumRepeats times
+	FAIDecisionReplayResult Replay(int32 NumRepeats = 1);
+
+	const FString& GetAgentName() const { return AgentName; }
+
+	const FAIOptionSelector& GetSelector() const { return Selector; }
+
+	int32 GetNumDecisions() const { return Frames.Num(); }
+
+private:
+
+	FString AgentName;
+
+	FAIOptionSelector Selector;
+
+	TArray<FSoftObjectPath> OptionSetPaths;
+
+	TArray<FAIDecisionReplayFrame> Frames;
+};
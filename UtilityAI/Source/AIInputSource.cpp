@@ -0,0 +1,40 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "AIInputSource.h"
+#include "AIQueryCache.h"
+
+
+float UAIInputSource::GetInput(const FDecisionMakerContext& Context) const
+{
+	return 0.f;
+}
+
+float UAIInputSource::GetSharedInput(const FDecisionMakerContext& Context) const
+{
+	if (SharedInputName.IsNone() || !Context.EvaluationQueryCache)
+		return GetInput(Context);
+
+	// The evaluation cache is emptied before each decision, so the value can't go stale.
+	// Targeted options share per target, since the input usually depends on it.
+	const UObject* Subject = Context.Target ? static_cast<const UObject*>(Context.Target) : Context.DecisionMaker;
+	return Context.EvaluationQueryCache->GetFloat(SharedInputName, Subject, [this, &Context]()
+	{
+		return GetInput(Context);
+	});
+}
+
+void UAIInputSource::GetInputBatch(TArrayView<const FDecisionMakerContext> Contexts, TArrayView<float> OutInputs) const
+{
+	check(Contexts.Num() == OutInputs.Num());
+
+	for (int32 Index = 0; Index < Contexts.Num(); ++Index)
+	{
+		OutInputs[Index] = GetSharedInput(Contexts[Index]);
+	}
+}
+
+FString UAIInputSource::GetInputDescription() const
+{
+	return GetClass()->GetName();
+}
@@ -0,0 +1,45 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/NoExportTypes.h"
+#include "AIShared.h"
+#include "AIInputSource.generated.h"
+
+
+/**
+ * Native provider of a single raw input value for a consideration (a distance, a health value, a time...).
+ * Subclass in C++ to feed UAIConsideration_ResponseCurve without going through Blueprint.
+ */
+UCLASS(Abstract, DefaultToInstanced, EditInlineNew)
+class UTILITYAI_API UAIInputSource : public UObject
+{
+	GENERATED_BODY()
+public:
+
+	/** Inputs with the same name are only read once per agent per decision, and shared by every consideration using them.
+		Only share inputs that read the same thing, eg. DistanceToTarget. Leave empty to read every time. */
+	UPROPERTY(EditAnywhere, Category = "Input")
+	FName SharedInputName;
+
+	// Get the raw (unnormalized) input value
+	virtual float GetInput(const FDecisionMakerContext& Context) const;
+
+	// GetInput, or the value read earlier in this decision if the input is shared
+	float GetSharedInput(const FDecisionMakerContext& Context) const;
+
+	// GetSharedInput for many contexts at once. Override if the inputs can be gathered faster together, and keep sharing by SharedInputName.
+	virtual void GetInputBatch(TArrayView<const FDecisionMakerContext> Contexts, TArrayView<float> OutInputs) const;
+
+	// Can GetInput run on a worker thread?
+	bool IsThreadSafe() const { return bThreadSafe; }
+
+	// Get a string to describe this input
+	virtual FString GetInputDescription() const;
+
+protected:
+
+	/** Subclasses set this in their constructor if GetInput only reads state that doesn't change during scoring. */
+	bool bThreadSafe = false;
+};
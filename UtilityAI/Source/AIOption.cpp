@@ -0,0 +1,46 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "AIOption.h"
+#include "AICompiledOptionSet.h"
+
+
+float UAIOption::GetCooldownTime(EDecisionHistoryQueryResult Result) const
+{
+	switch (Result)
+	{
+	case EDecisionHistoryQueryResult::Succeeded:
+		return CooldownOnSuccess;
+	case EDecisionHistoryQueryResult::Failed:
+		return CooldownOnFailure;
+	case EDecisionHistoryQueryResult::Aborted:
+		return CooldownOnAbort;
+	default:
+		return 0.f;
+	}
+}
+
+TSharedRef<const FAICompiledOptionSet> UAIOption::GetCompiledOption()
+{
+	if (!CompiledOption.IsValid())
+	{
+		UAIOption* const SingleOption[] = { this };
+		CompiledOption = FAICompiledOptionSet::Compile(SingleOption);
+	}
+
+	return CompiledOption.ToSharedRef();
+}
+
+void UAIOption::InvalidateCompiledOption()
+{
+	CompiledOption.Reset();
+}
+
+#if WITH_EDITOR
+void UAIOption::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+
+	InvalidateCompiledOption();
+}
+#endif
@@ -0,0 +1,87 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/NoExportTypes.h"
+#include "AIShared.h"
+#include "AIOption.generated.h"
+
+class UBehaviorTree;
+class UAIConsideration;
+class UAITargetGenerator;
+struct FAICompiledOptionSet;
+
+/**
+ * 
+ */
+UCLASS(Blueprintable, DefaultToInstanced, EditInlineNew)
+class UTILITYAI_API UAIOption : public UObject
+{
+	GENERATED_BODY()
+public:
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	FName OptionName;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	UBehaviorTree* BehaviorTree;
+
+	/** If this option has any weight>0, no lower rank options will be chosen */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float Rank = 0;
+
+	/** Start with this value when applying consideration multipliers */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float BaseAddend = 1.f;
+
+	UPROPERTY(Instanced, EditAnywhere, BlueprintReadWrite)
+	TArray<UAIConsideration*> Considerations;
+
+	/** Score this option once per target, and use the best target. Considerations read the target from Context.Target. */
+	UPROPERTY(Instanced, EditAnywhere, BlueprintReadWrite, Category = "Target")
+	UAITargetGenerator* TargetGenerator;
+
+	/** Object key that gets the chosen target before the behavior tree starts */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Target")
+	FName TargetBlackboardKey;
+
+	/** Only one member of a decision group can run this option at a time. Higher bidders get it first. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Group")
+	bool bExclusiveInGroup = false;
+
+	/** Options with the same cooldown name share a cooldown. Leave empty to use OptionName. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Cooldown")
+	FName CooldownName;
+
+	/** Seconds this option can't be picked for after its behavior succeeds */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Cooldown", meta = (ClampMin = "0"))
+	float CooldownOnSuccess = 0.f;
+
+	/** Seconds this option can't be picked for after its behavior fails */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Cooldown", meta = (ClampMin = "0"))
+	float CooldownOnFailure = 0.f;
+
+	/** Seconds this option can't be picked for after its behavior is aborted */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Cooldown", meta = (ClampMin = "0"))
+	float CooldownOnAbort = 0.f;
+
+	FName GetCooldownName() const { return CooldownName.IsNone() ? OptionName : CooldownName; }
+
+	float GetCooldownTime(EDecisionHistoryQueryResult Result) const;
+
+	// Get this option compiled into a set of its own, for scoring options that aren't in an option set asset. Built on first use.
+	TSharedRef<const FAICompiledOptionSet> GetCompiledOption();
+
+	// Throw away the compiled copy so it gets rebuilt next time. Call this after changing the option (or its considerations) at runtime.
+	UFUNCTION(BlueprintCallable, Category = "AIOption")
+	void InvalidateCompiledOption();
+
+#if WITH_EDITOR
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
+
+private:
+
+	TSharedPtr<const FAICompiledOptionSet> CompiledOption;
+};
@@ -0,0 +1,91 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "AIOptionSelector.h"
+
+
+int32 FAIOptionSelector::Select(TArrayView<const FAIOptionScore> Scores, float BestWeight, FRandomStream& RandomStream) const
+{
+	if (BestWeight <= 0)
+		return INDEX_NONE;
+
+	int32 SelectedIndex = INDEX_NONE;
+
+	switch (Strategy)
+	{
+	case EAIOptionSelectionStrategy::Best:
+	{
+		for (int32 Index = 0; Index < Scores.Num(); ++Index)
+		{
+			if (Scores[Index].Weight >= BestWeight)
+				return Index;
+		}
+		break;
+	}
+
+	case EAIOptionSelectionStrategy::TopFraction:
+	{
+		// Uniform reservoir sampling: the Nth candidate replaces the pick with a chance of 1/N
+		// Same fraction pruning used, so a fraction above 1 can't leave us with no candidates
+		const float MinimumWeight = BestWeight * GetPruneFraction();
+		int32 NumCandidates = 0;
+		for (int32 Index = 0; Index < Scores.Num(); ++Index)
+		{
+			if (Scores[Index].Weight <= 0 || Scores[Index].Weight < MinimumWeight)
+				continue;
+
+			++NumCandidates;
+			if (RandomStream.RandHelper(NumCandidates) == 0)
+				SelectedIndex = Index;
+		}
+		break;
+	}
+
+	case EAIOptionSelectionStrategy::WeightedRandom:
+	case EAIOptionSelectionStrategy::Softmax:
+	{
+		// Weighted reservoir sampling: each candidate replaces the pick with a chance of its weight over the total so far
+		const bool bSoftmax = Strategy == EAIOptionSelectionStrategy::Softmax;
+		if (bSoftmax && SoftmaxTemperature <= 0)
+		{
+			// A temperature of 0 is just picking the best
+			FAIOptionSelector BestSelector = *this;
+			BestSelector.Strategy = EAIOptionSelectionStrategy::Best;
+			return BestSelector.Select(Scores, BestWeight, RandomStream);
+		}
+
+		const float InverseTemperature = bSoftmax ? 1.f / SoftmaxTemperature : 0.f;
+		float TotalWeight = 0.f;
+		for (int32 Index = 0; Index < Scores.Num(); ++Index)
+		{
+			if (Scores[Index].Weight <= 0)
+				continue;
+
+			// Subtracting the best weight keeps the exponent at or below 0, so it can't overflow
+			const float Weight = bSoftmax ? FMath::Exp((Scores[Index].Weight - BestWeight) * InverseTemperature) : Scores[Index].Weight;
+			TotalWeight += Weight;
+			if (RandomStream.FRand() * TotalWeight < Weight)
+				SelectedIndex = Index;
+		}
+		break;
+	}
+	}
+
+	return SelectedIndex;
+}
+
+float FAIOptionSelector::GetPruneFraction() const
+{
+	switch (Strategy)
+	{
+	case EAIOptionSelectionStrategy::Best:
+		return 1.f;
+
+	case EAIOptionSelectionStrategy::TopFraction:
+		return FMath::Clamp(MinimumWeightFraction, 0.f, 1.f);
+
+	default:
+		// Anything with weight could be picked
+		return 0.f;
+	}
+}
@@ -0,0 +1,44 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AIShared.h"
+#include "AIOptionSelector.generated.h"
+
+
+UENUM(BlueprintType)
+enum class EAIOptionSelectionStrategy : uint8
+{
+	/** Always pick the option with the highest weight */
+	Best,
+
+	/** Pick at random from the options whose weights are within MinimumWeightFractionForRandomSelection of the best */
+	TopFraction,
+
+	/** Pick at random, with chances proportional to weight */
+	WeightedRandom,
+
+	/** Pick at random, with chances proportional to e^((Weight - BestWeight) / SoftmaxTemperature) */
+	Softmax
+};
+
+
+/**
+ * Picks an option from a list of scores in a single pass, without allocating.
+ * Random strategies use reservoir sampling, so every candidate gets its fair chance without building a candidate list.
+ */
+struct UTILITYAI_API FAIOptionSelector
+{
+	EAIOptionSelectionStrategy Strategy = EAIOptionSelectionStrategy::TopFraction;
+
+	float MinimumWeightFraction = 0.95f;
+
+	float SoftmaxTemperature = 1.f;
+
+	// Returns the index of the selected score, or INDEX_NONE if nothing has weight. BestWeight is the highest weight in Scores.
+	int32 Select(TArrayView<const FAIOptionScore> Scores, float BestWeight, FRandomStream& RandomStream) const;
+
+	// Options whose weights are less than this fraction of the best weight can never be selected, so there's no need to finish scoring them
+	float GetPruneFraction() const;
+};
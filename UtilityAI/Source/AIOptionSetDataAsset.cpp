@@ -0,0 +1,40 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "AIOptionSetDataAsset.h"
+
+
+TSharedRef<const FAICompiledOptionSet> UAIOptionSetDataAsset::GetCompiledOptionSet()
+{
+	if (!CompiledOptionSet.IsValid())
+	{
+		TSharedRef<FAICompiledOptionSet> Compiled = FAICompiledOptionSet::Compile(Options);
+		Compiled->SourcePath = FSoftObjectPath(this);
+		CompiledOptionSet = Compiled;
+	}
+
+	return CompiledOptionSet.ToSharedRef();
+}
+
+void UAIOptionSetDataAsset::InvalidateCompiledOptionSet()
+{
+	// Anyone still holding the old copy keeps it alive until they're done with it
+	CompiledOptionSet.Reset();
+}
+
+void UAIOptionSetDataAsset::PostLoad()
+{
+	Super::PostLoad();
+
+	InvalidateCompiledOptionSet();
+}
+
+#if WITH_EDITOR
+void UAIOptionSetDataAsset::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+
+	// This also catches edits to instanced options and considerations, since they're edited through the asset
+	InvalidateCompiledOptionSet();
+}
+#endif
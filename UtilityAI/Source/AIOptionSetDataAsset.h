@@ -0,0 +1,42 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "AIOption.h"
+#include "AICompiledOptionSet.h"
+#include "AIOptionSetDataAsset.generated.h"
+
+
+
+/**
+ *
+ */
+UCLASS()
+class UTILITYAI_API UAIOptionSetDataAsset : public UDataAsset
+{
+	GENERATED_BODY()
+
+public:
+	
+	UPROPERTY(Instanced, EditAnywhere, BlueprintReadWrite, Category = "AIOptionSet")
+	TArray<UAIOption*> Options;
+
+	// Get the flattened copy of Options used for scoring. It's built on first use and shared by every agent using this asset.
+	TSharedRef<const FAICompiledOptionSet> GetCompiledOptionSet();
+
+	// Throw away the compiled copy so it gets rebuilt next time. Call this after changing Options (or their considerations) at runtime.
+	UFUNCTION(BlueprintCallable, Category = "AIOptionSet")
+	void InvalidateCompiledOptionSet();
+
+	virtual void PostLoad() override;
+
+#if WITH_EDITOR
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
+
+private:
+
+	TSharedPtr<const FAICompiledOptionSet> CompiledOptionSet;
+};
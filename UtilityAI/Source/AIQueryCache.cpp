@@ -0,0 +1,114 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "AIQueryCache.h"
+
+
+template<typename ValueType>
+ValueType FAIQueryCache::GetOrCompute(TMap<FAIQueryKey, ValueType>& Values, const FAIQueryKey& Key, TFunctionRef<ValueType()> Compute)
+{
+	{
+		FReadScopeLock ReadLock(Lock);
+		if (const ValueType* Value = Values.Find(Key))
+			return *Value;
+	}
+
+	// Two threads might both compute the same query. The first one to finish wins.
+	ValueType Value = Compute();
+
+	FWriteScopeLock WriteLock(Lock);
+	if (const ValueType* Existing = Values.Find(Key))
+		return *Existing;
+
+	Values.Add(Key, Value);
+	return Value;
+}
+
+float FAIQueryCache::GetFloat(FName Query, const UObject* Subject, TFunctionRef<float()> Compute)
+{
+	return GetOrCompute(Floats, { Query, FObjectKey(Subject) }, Compute);
+}
+
+FVector FAIQueryCache::GetVector(FName Query, const UObject* Subject, TFunctionRef<FVector()> Compute)
+{
+	return GetOrCompute(Vectors, { Query, FObjectKey(Subject) }, Compute);
+}
+
+AActor* FAIQueryCache::GetActor(FName Query, const UObject* Subject, TFunctionRef<AActor*()> Compute)
+{
+	return GetOrCompute(Actors, { Query, FObjectKey(Subject) }, Compute);
+}
+
+void FAIQueryCache::GetActors(FName Query, const UObject* Subject, TArray<AActor*>& OutActors, TFunctionRef<void(TArray<AActor*>&)> Compute)
+{
+	const FAIQueryKey Key{ Query, FObjectKey(Subject) };
+
+	{
+		FReadScopeLock ReadLock(Lock);
+		if (const int32* Cached = ActorLists.Find(Key))
+		{
+			OutActors.Reset();
+			OutActors.Append(ActorListPool[*Cached]);
+			return;
+		}
+	}
+
+	OutActors.Reset();
+	Compute(OutActors);
+
+	FWriteScopeLock WriteLock(Lock);
+	if (const int32* Existing = ActorLists.Find(Key))
+	{
+		OutActors.Reset();
+		OutActors.Append(ActorListPool[*Existing]);
+		return;
+	}
+
+	if (NumActorLists == ActorListPool.Num())
+	{
+		ActorListPool.AddDefaulted();
+	}
+
+	// Reset and Append only ever grow a list, where assigning could reallocate it
+	TArray<AActor*>& ActorList = ActorListPool[NumActorLists];
+	ActorList.Reset();
+	ActorList.Append(OutActors);
+	ActorLists.Add(Key, NumActorLists++);
+}
+
+void FAIQueryCache::Reset()
+{
+	FWriteScopeLock WriteLock(Lock);
+
+	Floats.Reset();
+	Vectors.Reset();
+	Actors.Reset();
+	ActorLists.Reset();
+	NumActorLists = 0;
+}
+
+void FAIQueryCache::ResetIfNewFrame(uint64 FrameNumber)
+{
+	{
+		FReadScopeLock ReadLock(Lock);
+		if (LastFrameNumber == FrameNumber)
+			return;
+	}
+
+	Reset();
+
+	FWriteScopeLock WriteLock(Lock);
+	LastFrameNumber = FrameNumber;
+}
+
+SIZE_T FAIQueryCache::GetAllocatedSize() const
+{
+	FReadScopeLock ReadLock(Lock);
+
+	SIZE_T Size = Floats.GetAllocatedSize() + Vectors.GetAllocatedSize() + Actors.GetAllocatedSize() + ActorLists.GetAllocatedSize() + ActorListPool.GetAllocatedSize();
+	for (const TArray<AActor*>& ActorList : ActorListPool)
+	{
+		Size += ActorList.GetAllocatedSize();
+	}
+	return Size;
+}
@@ -0,0 +1,75 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/ObjectKey.h"
+#include "Misc/ScopeRWLock.h"
+
+
+class AActor;
+
+/** A query is identified by its name and what it's about (usually the pawn or controller asking) */
+struct FAIQueryKey
+{
+	FName Query;
+
+	FObjectKey Subject;
+
+	bool operator==(const FAIQueryKey& Other) const
+	{
+		return Query == Other.Query && Subject == Other.Subject;
+	}
+
+	friend uint32 GetTypeHash(const FAIQueryKey& Key)
+	{
+		return HashCombine(GetTypeHash(Key.Query), GetTypeHash(Key.Subject));
+	}
+};
+
+
+/**
+ * Remembers the results of expensive queries (nearest enemy, visible allies, distance to cover...) so they only run once.
+ * Decision makers keep one per evaluation, and the UtilityAISubsystem keeps one per frame that every decision maker shares.
+ * Queries are computed outside the lock, so they can use the cache themselves. Safe to use from scoring worker threads.
+ */
+class UTILITYAI_API FAIQueryCache
+{
+public:
+
+	float GetFloat(FName Query, const UObject* Subject, TFunctionRef<float()> Compute);
+
+	FVector GetVector(FName Query, const UObject* Subject, TFunctionRef<FVector()> Compute);
+
+	AActor* GetActor(FName Query, const UObject* Subject, TFunctionRef<AActor*()> Compute);
+
+	// Copies the cached list into OutActors
+	void GetActors(FName Query, const UObject* Subject, TArray<AActor*>& OutActors, TFunctionRef<void(TArray<AActor*>&)> Compute);
+
+	// Forget everything, keeping the memory for next time
+	void Reset();
+
+	// Reset if we haven't been used yet this frame
+	void ResetIfNewFrame(uint64 FrameNumber);
+
+	SIZE_T GetAllocatedSize() const;
+
+private:
+
+	template<typename ValueType>
+	ValueType GetOrCompute(TMap<FAIQueryKey, ValueType>& Values, const FAIQueryKey& Key, TFunctionRef<ValueType()> Compute);
+
+	mutable FRWLock Lock;
+
+	uint64 LastFrameNumber = 0;
+
+	// Actors are only kept for a frame (or one evaluation), so they can't be garbage collected from under us
+	TMap<FAIQueryKey, float> Floats;
+	TMap<FAIQueryKey, FVector> Vectors;
+	TMap<FAIQueryKey, AActor*> Actors;
+
+	// Lists live in ActorListPool so their memory survives a Reset. Only the first NumActorLists are in use.
+	TMap<FAIQueryKey, int32> ActorLists;
+	TArray<TArray<AActor*>> ActorListPool;
+	int32 NumActorLists = 0;
+};
@@ -0,0 +1,78 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "AIQueryLibrary.h"
+#include "AIQueryCache.h"
+#include "AIController.h"
+#include "Perception/AIPerceptionComponent.h"
+#include "Perception/AISense.h"
+
+
+namespace AIQueryLibrary
+{
+	static const FName NAME_AnySense(TEXT("AnySense"));
+	static const FName NAME_NearestPerceivedActor(TEXT("NearestPerceivedActor"));
+}
+
+
+void UAIQueryLibrary::GetPerceivedActors(const FDecisionMakerContext& Context, TSubclassOf<UAISense> Sense, TArray<AActor*>& OutActors)
+{
+	OutActors.Reset();
+
+	AAIController* AIController = Context.AIController;
+	if (!AIController)
+		return;
+
+	auto Compute = [AIController, Sense](TArray<AActor*>& Actors)
+	{
+		if (UAIPerceptionComponent* PerceptionComp = AIController->GetAIPerceptionComponent())
+		{
+			PerceptionComp->GetCurrentlyPerceivedActors(Sense, Actors);
+		}
+	};
+
+	if (Context.FrameQueryCache)
+	{
+		const FName QueryName = Sense ? Sense->GetFName() : AIQueryLibrary::NAME_AnySense;
+		Context.FrameQueryCache->GetActors(QueryName, AIController, OutActors, Compute);
+	}
+	else
+	{
+		Compute(OutActors);
+	}
+}
+
+AActor* UAIQueryLibrary::GetNearestPerceivedActor(const FDecisionMakerContext& Context, TSubclassOf<UAISense> Sense)
+{
+	if (!Context.Pawn)
+		return nullptr;
+
+	auto Compute = [&Context, Sense]() -> AActor*
+	{
+		// Reused by every query on this thread, so it only allocates while it's growing
+		static thread_local TArray<AActor*> Actors;
+		GetPerceivedActors(Context, Sense, Actors);
+
+		const FVector PawnLocation = Context.Pawn->GetActorLocation();
+		AActor* Nearest = nullptr;
+		double NearestDistanceSquared = TNumericLimits<double>::Max();
+		for (AActor* Actor : Actors)
+		{
+			if (!Actor)
+				continue;
+
+			const double DistanceSquared = FVector::DistSquared(PawnLocation, Actor->GetActorLocation());
+			if (DistanceSquared < NearestDistanceSquared)
+			{
+				NearestDistanceSquared = DistanceSquared;
+				Nearest = Actor;
+			}
+		}
+		return Nearest;
+	};
+
+	// The evaluation cache already belongs to this agent, so the subject only needs to tell the senses apart
+	return Context.EvaluationQueryCache
+		? Context.EvaluationQueryCache->GetActor(AIQueryLibrary::NAME_NearestPerceivedActor, Sense.Get(), Compute)
+		: Compute();
+}
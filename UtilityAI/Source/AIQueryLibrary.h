@@ -0,0 +1,29 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Kismet/BlueprintFunctionLibrary.h"
+#include "AIShared.h"
+#include "AIQueryLibrary.generated.h"
+
+
+class UAISense;
+
+/**
+ * Common queries for considerations, cached in the decision maker context so they only run once per decision (or once per frame).
+ */
+UCLASS()
+class UTILITYAI_API UAIQueryLibrary : public UBlueprintFunctionLibrary
+{
+	GENERATED_BODY()
+public:
+
+	/** Actors the AI controller currently perceives with Sense (or any sense, if not set). Shared by everything that asks this frame. */
+	UFUNCTION(BlueprintCallable, Category = "UtilityAI|Queries")
+	static void GetPerceivedActors(const FDecisionMakerContext& Context, TSubclassOf<UAISense> Sense, TArray<AActor*>& OutActors);
+
+	/** The closest actor to the pawn that the AI controller currently perceives with Sense (or any sense, if not set) */
+	UFUNCTION(BlueprintCallable, Category = "UtilityAI|Queries")
+	static AActor* GetNearestPerceivedActor(const FDecisionMakerContext& Context, TSubclassOf<UAISense> Sense);
+};
@@ -0,0 +1,131 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "AIResponseCurve.h"
+
+
+namespace AIResponseCurve
+{
+	// Keep logit away from 0 and 1, where it goes to infinity
+	static constexpr float LogitEpsilon = 1.e-4f;
+
+	struct FVectorParams
+	{
+		VectorRegister4Float Slope;
+		VectorRegister4Float NegativeSlope;
+		VectorRegister4Float InverseSlope;
+		VectorRegister4Float XShift;
+		VectorRegister4Float YShift;
+		VectorRegister4Float LogitMin;
+		VectorRegister4Float LogitMax;
+	};
+
+	FORCEINLINE VectorRegister4Float EvaluateVector(EAIResponseCurveType Type, const FVectorParams& Params, const VectorRegister4Float& X)
+	{
+		const VectorRegister4Float One = VectorOneFloat();
+		const VectorRegister4Float Delta = VectorSubtract(X, Params.XShift);
+
+		switch (Type)
+		{
+		case EAIResponseCurveType::Quadratic:
+			return VectorMultiplyAdd(VectorMultiply(Params.Slope, Delta), Delta, Params.YShift);
+
+		case EAIResponseCurveType::Logistic:
+		{
+			const VectorRegister4Float Exponential = VectorExp(VectorMultiply(Params.NegativeSlope, Delta));
+			return VectorAdd(VectorDivide(One, VectorAdd(One, Exponential)), Params.YShift);
+		}
+
+		case EAIResponseCurveType::Logit:
+		{
+			const VectorRegister4Float Clamped = VectorMin(VectorMax(Delta, Params.LogitMin), Params.LogitMax);
+			const VectorRegister4Float Odds = VectorDivide(Clamped, VectorSubtract(One, Clamped));
+			return VectorMultiplyAdd(VectorLog(Odds), Params.InverseSlope, Params.YShift);
+		}
+
+		case EAIResponseCurveType::Linear:
+		default:
+			return VectorMultiplyAdd(Params.Slope, Delta, Params.YShift);
+		}
+	}
+}
+
+
+float FAIResponseCurve::Evaluate(float X) const
+{
+	if (Type == EAIResponseCurveType::Custom)
+		return FMath::Clamp(CustomCurve.GetRichCurveConst()->Eval(X), 0.f, 1.f);
+
+	return EvaluateFormula(Type, Slope, XShift, YShift, X);
+}
+
+float FAIResponseCurve::EvaluateFormula(EAIResponseCurveType Type, float Slope, float XShift, float YShift, float X)
+{
+	const float Delta = X - XShift;
+	float Y = 0.f;
+
+	switch (Type)
+	{
+	case EAIResponseCurveType::Linear:
+		Y = Slope * Delta + YShift;
+		break;
+
+	case EAIResponseCurveType::Quadratic:
+		Y = Slope * Delta * Delta + YShift;
+		break;
+
+	case EAIResponseCurveType::Logistic:
+		Y = 1.f / (1.f + FMath::Exp(-Slope * Delta)) + YShift;
+		break;
+
+	case EAIResponseCurveType::Logit:
+	{
+		const float Clamped = FMath::Clamp(Delta, AIResponseCurve::LogitEpsilon, 1.f - AIResponseCurve::LogitEpsilon);
+		const float InverseSlope = Slope != 0 ? 1.f / Slope : 0.f;
+		Y = FMath::Loge(Clamped / (1.f - Clamped)) * InverseSlope + YShift;
+		break;
+	}
+
+	case EAIResponseCurveType::Custom:
+		checkNoEntry();
+		break;
+	}
+
+	return FMath::Clamp(Y, 0.f, 1.f);
+}
+
+void FAIResponseCurve::EvaluateBatch(TArrayView<const float> X, TArrayView<float> OutY) const
+{
+	check(X.Num() == OutY.Num());
+
+	const int32 Num = X.Num();
+	int32 Index = 0;
+
+	// Custom curves are sampled one key at a time, so there's nothing to gain
+	if (Type != EAIResponseCurveType::Custom)
+	{
+		AIResponseCurve::FVectorParams Params;
+		Params.Slope = VectorSetFloat1(Slope);
+		Params.NegativeSlope = VectorSetFloat1(-Slope);
+		Params.InverseSlope = VectorSetFloat1(Slope != 0 ? 1.f / Slope : 0.f);
+		Params.XShift = VectorSetFloat1(XShift);
+		Params.YShift = VectorSetFloat1(YShift);
+		Params.LogitMin = VectorSetFloat1(AIResponseCurve::LogitEpsilon);
+		Params.LogitMax = VectorSetFloat1(1.f - AIResponseCurve::LogitEpsilon);
+
+		const VectorRegister4Float Zero = VectorZeroFloat();
+		const VectorRegister4Float One = VectorOneFloat();
+
+		for (; Index + 4 <= Num; Index += 4)
+		{
+			const VectorRegister4Float Y = AIResponseCurve::EvaluateVector(Type, Params, VectorLoad(X.GetData() + Index));
+			VectorStore(VectorMin(VectorMax(Y, Zero), One), OutY.GetData() + Index);
+		}
+	}
+
+	// Whatever doesn't fit in a vector register
+	for (; Index < Num; ++Index)
+	{
+		OutY[Index] = Evaluate(X[Index]);
+	}
+}
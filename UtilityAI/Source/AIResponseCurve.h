@@ -0,0 +1,61 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Curves/CurveFloat.h"
+#include "AIResponseCurve.generated.h"
+
+
+UENUM(BlueprintType)
+enum class EAIResponseCurveType : uint8
+{
+	/** y = Slope * (x - XShift) + YShift */
+	Linear,
+
+	/** y = Slope * (x - XShift)^2 + YShift */
+	Quadratic,
+
+	/** y = 1 / (1 + e^(-Slope * (x - XShift))) + YShift */
+	Logistic,
+
+	/** y = ln(x' / (1 - x')) / Slope + YShift, where x' = x - XShift */
+	Logit,
+
+	/** Sample CustomCurve. Can't be vectorized. */
+	Custom
+};
+
+
+/**
+ * Maps a normalized input (0-1) to a normalized output (0-1).
+ */
+USTRUCT(BlueprintType)
+struct UTILITYAI_API FAIResponseCurve
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ResponseCurve")
+	EAIResponseCurveType Type = EAIResponseCurveType::Linear;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ResponseCurve", meta = (EditCondition = "Type != EAIResponseCurveType::Custom"))
+	float Slope = 1.f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ResponseCurve", meta = (EditCondition = "Type != EAIResponseCurveType::Custom"))
+	float XShift = 0.f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ResponseCurve", meta = (EditCondition = "Type != EAIResponseCurveType::Custom"))
+	float YShift = 0.f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ResponseCurve", meta = (EditCondition = "Type == EAIResponseCurveType::Custom"))
+	FRuntimeFloatCurve CustomCurve;
+
+	// Evaluate one input. The result is clamped to 0-1.
+	float Evaluate(float X) const;
+
+	// Evaluate one input with one of the formula curves (anything but Custom). The result is clamped to 0-1.
+	static float EvaluateFormula(EAIResponseCurveType Type, float Slope, float XShift, float YShift, float X);
+
+	// Evaluate many inputs at once, four at a time using vector registers. Results are clamped to 0-1.
+	void EvaluateBatch(TArrayView<const float> X, TArrayView<float> OutY) const;
+};
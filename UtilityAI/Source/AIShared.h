@@ -0,0 +1,144 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Misc/EngineVersionComparison.h"
+
+#include "AIShared.generated.h"
+
+
+class AActor;
+class AAIController;
+class UDecisionMakerComponent;
+class UAIOption;
+class FAIConsiderationCache;
+class FAIQueryCache;
+class FAIDecisionRecorder;
+class FAIDecisionGroup;
+struct FAICooldownStore;
+struct FAIDecisionReplayFrame;
+struct FDecisionHistory;
+struct FDecisionRecord;
+struct FMassExecutionContext;
+
+DECLARE_LOG_CATEGORY_EXTERN(LogDM, Display, All);
+
+#define TOFLAG(Enum) (1 << static_cast<uint8>(Enum))
+
+#if UE_VERSION_OLDER_THAN(5, 4, 0)
+// TArray took a bool for whether to shrink before EAllowShrinking, so spell it the new way on older engines too
+struct EAllowShrinking
+{
+	static constexpr bool No = false;
+	static constexpr bool Yes = true;
+};
+#endif
+
+UENUM(BlueprintType)
+enum class EDecisionHistoryQueryTime : uint8
+{
+	Started,
+	Ended
+
+};
+
+UENUM(BlueprintType, meta = (Bitflags))
+enum class EDecisionHistoryQueryResult : uint8
+{
+	InProgress,
+	Succeeded,
+	Failed,
+	Aborted
+};
+
+
+USTRUCT(BlueprintType)
+struct FDecisionMakerContext
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintreadOnly)
+	UDecisionMakerComponent* DecisionMaker = nullptr;
+
+	UPROPERTY(BlueprintreadWrite)
+	AAIController* AIController = nullptr;
+
+	UPROPERTY(BlueprintreadWrite)
+	APawn* Pawn = nullptr;
+
+	// The target being scored, for options with a target generator
+	UPROPERTY(BlueprintReadOnly)
+	AActor* Target = nullptr;
+
+	// Which of the option's targets is being scored. Recordings tell targets apart by this, since replays have no actors.
+	int32 TargetIndex = INDEX_NONE;
+
+	// Time the decision is being made at
+	double CurrentTime = 0;
+
+	// Where to cache consideration scores for this agent. Nothing is cached if this isn't set.
+	FAIConsiderationCache* ConsiderationCache = nullptr;
+
+	// Scratch cache for queries about this agent. Emptied at the start of each decision.
+	FAIQueryCache* EvaluationQueryCache = nullptr;
+
+	// Cache for queries shared by every decision maker in the world this frame
+	FAIQueryCache* FrameQueryCache = nullptr;
+
+	// Options whose cooldown is running here are skipped
+	const FAICooldownStore* Cooldowns = nullptr;
+
+	// Set when the agent decides with a group. Shares scores of bSharedInGroup considerations, and skips exclusive options held by other members.
+	FAIDecisionGroup* DecisionGroup = nullptr;
+
+	// Agents without a decision maker (eg. Mass entities) pass their history here instead
+	const FDecisionHistory* DecisionHistory = nullptr;
+	const FDecisionRecord* CurrentDecisionRecord = nullptr;
+
+	// Set when scoring a Mass entity. Considerations can read the entity's fragments from the chunk.
+	const FMassExecutionContext* MassContext = nullptr;
+	int32 MassEntityIndex = INDEX_NONE;
+
+	// Set while the decision maker is recording. Considerations with a raw input can record it here.
+	FAIDecisionRecorder* DecisionRecorder = nullptr;
+
+	// Set while replaying a recording. Recorded inputs and scores are used instead of querying the world.
+	const FAIDecisionReplayFrame* ReplayFrame = nullptr;
+};
+
+
+USTRUCT(BlueprintType)
+struct FAIConsiderationScore
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadWrite)
+	float Addend = 0;
+
+	UPROPERTY(BlueprintReadWrite)
+	float Multiplier = 1.f;
+};
+
+
+USTRUCT(BlueprintType)
+struct FAIOptionScore
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadWrite)
+	float Rank = 0;
+
+	UPROPERTY(BlueprintReadWrite)
+	float Weight = 0;
+
+	UPROPERTY(BlueprintReadWrite)
+	UAIOption* Option;
+
+	// Best target, for options with a target generator
+	UPROPERTY(BlueprintReadWrite)
+	AActor* Target = nullptr;
+
+	// Scoring stopped early because this option couldn't beat the options already scored
+	bool bPruned = false;
+};
\ No newline at end of file
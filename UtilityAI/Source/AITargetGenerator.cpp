@@ -0,0 +1,9 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "AITargetGenerator.h"
+
+
+void UAITargetGenerator::GenerateTargets(const FDecisionMakerContext& Context, TArray<AActor*>& OutTargets) const
+{
+}
@@ -0,0 +1,35 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/NoExportTypes.h"
+#include "AIShared.h"
+#include "AITargetGenerator.generated.h"
+
+
+/**
+ * Gives an option a list of targets to choose between. The option's considerations are scored for every target in one batch
+ * (with the target in Context.Target), and the option's weight is its best target's weight.
+ */
+UCLASS(Abstract, DefaultToInstanced, EditInlineNew)
+class UTILITYAI_API UAITargetGenerator : public UObject
+{
+	GENERATED_BODY()
+public:
+
+	/** Only score this many targets. 0 means no limit. */
+	UPROPERTY(EditAnywhere, Category = "Targets", meta = (ClampMin = "0"))
+	int32 MaxTargets = 0;
+
+	// Add the targets for the agent in Context to OutTargets
+	virtual void GenerateTargets(const FDecisionMakerContext& Context, TArray<AActor*>& OutTargets) const;
+
+	// Can GenerateTargets run on a worker thread?
+	bool IsThreadSafe() const { return bThreadSafe; }
+
+protected:
+
+	/** Subclasses set this in their constructor if GenerateTargets only reads state that doesn't change during scoring. */
+	bool bThreadSafe = false;
+};
@@ -0,0 +1,59 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "BTT_RunOptionBehaviorTree.h"
+#include "AIController.h"
+#include "DecisionMakerComponent.h"
+#include "DMBehaviorTreeComponent.h"
+
+
+TAutoConsoleVariable<int32> CVarShowAITaskTreeResults(
+	TEXT("ShowAITaskTreeResults"),
+	0,
+	TEXT("Show the results of AI Task trees.\n")
+	TEXT("  0: off\n")
+	TEXT("  1: on\n")
+);
+
+
+
+EBTNodeResult::Type UBTT_RunOptionBehaviorTree::ExecuteTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory)
+{
+	// Set the behavior tree using CAIController's current AI Task tree
+	if (UDecisionMakerComponent* DecisionMaker = GetDecisionMaker(OwnerComp))
+	{
+		if (UBehaviorTree* OptionTree = DecisionMaker->GetCurrentOptionTree())
+		{
+			// Options often share trees, so don't bother if it's already set
+			if (BehaviorAsset != OptionTree)
+			{
+				SetBehaviorAsset(OptionTree);
+			}
+			DecisionMaker->AIOptionBehaviorStartedEvent.Broadcast();
+		}
+	}
+
+	return Super::ExecuteTask(OwnerComp, NodeMemory);
+}
+
+void UBTT_RunOptionBehaviorTree::OnSubtreeDeactivated(UBehaviorTreeComponent& OwnerComp, EBTNodeResult::Type NodeResult)
+{
+	Super::OnSubtreeDeactivated(OwnerComp, NodeResult);
+
+	if (UDecisionMakerComponent* DecisionMaker = GetDecisionMaker(OwnerComp))
+	{
+		DecisionMaker->AIOptionBehaviorEndedEvent.Broadcast(NodeResult);
+	}
+}
+
+UDecisionMakerComponent* UBTT_RunOptionBehaviorTree::GetDecisionMaker(UBehaviorTreeComponent& OwnerComp) const
+{
+	if (const UDMBehaviorTreeComponent* DMBehaviorTreeComp = Cast<UDMBehaviorTreeComponent>(&OwnerComp))
+	{
+		if (UDecisionMakerComponent* DecisionMaker = DMBehaviorTreeComp->GetDecisionMaker())
+			return DecisionMaker;
+	}
+
+	AAIController* AIController = OwnerComp.GetAIOwner();
+	return AIController ? AIController->FindComponentByClass<UDecisionMakerComponent>() : nullptr;
+}
@@ -6,6 +6,9 @@
 #include "BehaviorTree/Tasks/BTTask_RunBehaviorDynamic.h"
 #include "BTT_RunOptionBehaviorTree.generated.h"
 
+
+class UDecisionMakerComponent;
+
 /**
  * 
  */
@@ -20,4 +23,9 @@ public:
 
 	virtual void OnSubtreeDeactivated(UBehaviorTreeComponent& OwnerComp, EBTNodeResult::Type NodeResult);
 
+protected:
+
+	// Use the decision maker cached on the DMBehaviorTreeComponent, and only search the controller if there isn't one
+	UDecisionMakerComponent* GetDecisionMaker(UBehaviorTreeComponent& OwnerComp) const;
+
 };
@@ -0,0 +1,40 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "AIConsideration_DecisionHistory.h"
+#include "DecisionMakerComponent.h"
+
+
+UAIConsideration_DecisionHistory::UAIConsideration_DecisionHistory()
+{
+	// Only reads decision history, which doesn't change while options are being scored
+	bThreadSafe = true;
+}
+
+
+FAIConsiderationScore UAIConsideration_DecisionHistory::CalculateScore_Implementation(const FDecisionMakerContext& Context)
+{
+	float TimeElapsed = AIDecisionHistoryQuery::GetTimeSince(Context, OptionNameToQuery, QueryTime, QueryResultBitmask);
+
+	if (TimeElapsed < 0)
+	{
+		TimeElapsed = INFINITY;
+	}
+
+	FAIConsiderationScore Score;
+
+	Score.Multiplier = FMath::GetMappedRangeValueClamped(TimeRange, MultiplierRange, TimeElapsed);
+
+	return Score;
+}
+
+bool UAIConsideration_DecisionHistory::GetScoreBounds(FAIConsiderationScore& OutMaxScore) const
+{
+	// The multiplier is clamped to MultiplierRange. Bounds don't work with negative multipliers.
+	if (FMath::Min(MultiplierRange.X, MultiplierRange.Y) < 0)
+		return false;
+
+	OutMaxScore.Addend = 0.f;
+	OutMaxScore.Multiplier = FMath::Max(MultiplierRange.X, MultiplierRange.Y);
+	return true;
+}
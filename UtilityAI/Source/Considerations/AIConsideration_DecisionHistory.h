@@ -32,5 +32,9 @@ public:
 	UPROPERTY(EditAnywhere)
 	FVector2D MultiplierRange;
 
+	UAIConsideration_DecisionHistory();
+
 	virtual FAIConsiderationScore CalculateScore_Implementation(const FDecisionMakerContext& Context) override;
+
+	virtual bool GetScoreBounds(FAIConsiderationScore& OutMaxScore) const override;
 };
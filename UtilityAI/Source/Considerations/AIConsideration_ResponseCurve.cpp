@@ -0,0 +1,144 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "AIConsideration_ResponseCurve.h"
+#include "AIInputSource.h"
+#include "AIDecisionRecording.h"
+
+
+UAIConsideration_ResponseCurve::UAIConsideration_ResponseCurve()
+{
+	// Thread safety also depends on the input source. See IsThreadSafe.
+	bThreadSafe = true;
+}
+
+
+FAIConsiderationScore UAIConsideration_ResponseCurve::CalculateScore_Implementation(const FDecisionMakerContext& Context)
+{
+	float RawInput = 0.f;
+	if (!Context.ReplayFrame || !Context.ReplayFrame->FindInput(this, Context.TargetIndex, RawInput))
+	{
+		RawInput = Input ? Input->GetSharedInput(Context) : 0.f;
+	}
+
+	if (Context.DecisionRecorder)
+	{
+		Context.DecisionRecorder->RecordInput(this, Context.TargetIndex, RawInput);
+	}
+
+	const FAICompiledResponseCurve Parameters = GetCurveParameters();
+	return Parameters.MakeScore(Curve.Evaluate(Parameters.NormalizeInput(RawInput)));
+}
+
+void UAIConsideration_ResponseCurve::CalculateScoreBatch(TArrayView<const FDecisionMakerContext> Contexts, TArrayView<FAIConsiderationScore> OutScores)
+{
+	check(Contexts.Num() == OutScores.Num());
+
+	TArray<float, TInlineAllocator<256>> Values;
+	Values.SetNumUninitialized(Contexts.Num());
+
+	// Replays use the recorded inputs, same as CalculateScore. Contexts in a batch all come from the same decision.
+	const FAIDecisionReplayFrame* ReplayFrame = Contexts.Num() > 0 ? Contexts[0].ReplayFrame : nullptr;
+	if (ReplayFrame)
+	{
+		for (int32 Index = 0; Index < Contexts.Num(); ++Index)
+		{
+			if (!ReplayFrame->FindInput(this, Contexts[Index].TargetIndex, Values[Index]))
+			{
+				Values[Index] = Input ? Input->GetSharedInput(Contexts[Index]) : 0.f;
+			}
+		}
+	}
+	else if (Input)
+	{
+		Input->GetInputBatch(Contexts, Values);
+	}
+	else
+	{
+		FMemory::Memzero(Values.GetData(), Values.Num() * sizeof(float));
+	}
+
+	// Recordings keep each target's input apart by TargetIndex
+	for (int32 Index = 0; Index < Contexts.Num(); ++Index)
+	{
+		if (Contexts[Index].DecisionRecorder)
+		{
+			Contexts[Index].DecisionRecorder->RecordInput(this, Contexts[Index].TargetIndex, Values[Index]);
+		}
+	}
+
+	const FAICompiledResponseCurve Parameters = GetCurveParameters();
+
+	for (float& Value : Values)
+	{
+		Value = Parameters.NormalizeInput(Value);
+	}
+
+	// Inputs and outputs can share the buffer
+	Curve.EvaluateBatch(Values, Values);
+
+	for (int32 Index = 0; Index < Values.Num(); ++Index)
+	{
+		OutScores[Index] = Parameters.MakeScore(Values[Index]);
+	}
+}
+
+bool UAIConsideration_ResponseCurve::IsThreadSafe() const
+{
+	return Super::IsThreadSafe() && (!Input || Input->IsThreadSafe());
+}
+
+bool UAIConsideration_ResponseCurve::GetScoreBounds(FAIConsiderationScore& OutMaxScore) const
+{
+	// The curve output is clamped to 0-1, so the score always lands inside OutputRange
+	const float MaxValue = FMath::Max(OutputRange.X, OutputRange.Y);
+
+	if (bApplyAsAddend)
+	{
+		OutMaxScore.Addend = MaxValue;
+		OutMaxScore.Multiplier = 1.f;
+		return true;
+	}
+
+	if (FMath::Min(OutputRange.X, OutputRange.Y) < 0)
+		return false;
+
+	OutMaxScore.Addend = 0.f;
+	OutMaxScore.Multiplier = MaxValue;
+	return true;
+}
+
+FString UAIConsideration_ResponseCurve::GetConsiderationDescription()
+{
+	FString Output = Super::GetConsiderationDescription();
+	if (Input)
+	{
+		Output.Append(FString(" <- "));
+		Output.Append(Input->GetInputDescription());
+	}
+	return Output;
+}
+
+bool UAIConsideration_ResponseCurve::CompileResponseCurve(FAICompiledResponseCurve& OutResponseCurve) const
+{
+	// Subclasses may score differently, and custom curves need the curve asset
+	if (GetClass() != UAIConsideration_ResponseCurve::StaticClass() || Curve.Type == EAIResponseCurveType::Custom)
+		return false;
+
+	OutResponseCurve = GetCurveParameters();
+	return true;
+}
+
+FAICompiledResponseCurve UAIConsideration_ResponseCurve::GetCurveParameters() const
+{
+	FAICompiledResponseCurve Parameters;
+	Parameters.Input = Input;
+	Parameters.InputRange = InputRange;
+	Parameters.OutputRange = OutputRange;
+	Parameters.Type = Curve.Type;
+	Parameters.Slope = Curve.Slope;
+	Parameters.XShift = Curve.XShift;
+	Parameters.YShift = Curve.YShift;
+	Parameters.bApplyAsAddend = bApplyAsAddend;
+	return Parameters;
+}
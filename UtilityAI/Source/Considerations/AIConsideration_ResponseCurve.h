@@ -0,0 +1,61 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AIConsideration.h"
+#include "AIResponseCurve.h"
+#include "AICompiledOptionSet.h"
+#include "AIConsideration_ResponseCurve.generated.h"
+
+
+class UAIInputSource;
+
+/**
+ * Native consideration: reads a value from an input source, normalizes it with InputRange, runs it through a response curve
+ * and maps the result to OutputRange.
+ */
+UCLASS(BlueprintType)
+class UTILITYAI_API UAIConsideration_ResponseCurve : public UAIConsideration
+{
+	GENERATED_BODY()
+public:
+
+	UPROPERTY(Instanced, EditAnywhere, Category = "Input")
+	UAIInputSource* Input;
+
+	/** Raw input values in this range are mapped to 0-1 before going through the curve */
+	UPROPERTY(EditAnywhere, Category = "Input")
+	FVector2D InputRange = FVector2D(0.f, 1.f);
+
+	UPROPERTY(EditAnywhere, Category = "Curve")
+	FAIResponseCurve Curve;
+
+	/** The curve's 0-1 result is mapped to this range */
+	UPROPERTY(EditAnywhere, Category = "Output")
+	FVector2D OutputRange = FVector2D(0.f, 1.f);
+
+	/** Apply the result as an addend instead of a multiplier */
+	UPROPERTY(EditAnywhere, Category = "Output")
+	bool bApplyAsAddend = false;
+
+	UAIConsideration_ResponseCurve();
+
+	virtual FAIConsiderationScore CalculateScore_Implementation(const FDecisionMakerContext& Context) override;
+
+	virtual void CalculateScoreBatch(TArrayView<const FDecisionMakerContext> Contexts, TArrayView<FAIConsiderationScore> OutScores) override;
+
+	virtual bool IsThreadSafe() const override;
+
+	virtual bool GetScoreBounds(FAIConsiderationScore& OutMaxScore) const override;
+
+	virtual FString GetConsiderationDescription() override;
+
+	// Copy the parameters for a compiled option set to score from. False if the consideration has to be called instead,
+	// eg. for custom curves or subclasses.
+	bool CompileResponseCurve(FAICompiledResponseCurve& OutResponseCurve) const;
+
+protected:
+
+	FAICompiledResponseCurve GetCurveParameters() const;
+};
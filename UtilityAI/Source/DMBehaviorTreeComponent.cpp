@@ -0,0 +1,22 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "DMBehaviorTreeComponent.h"
+#include "DecisionMakerComponent.h"
+
+
+
+void UDMBehaviorTreeComponent::SetLooping(bool bEnabled)
+{
+	bLoopExecution = bEnabled;
+}
+
+void UDMBehaviorTreeComponent::SetDecisionMaker(UDecisionMakerComponent* InDecisionMaker)
+{
+	DecisionMaker = InDecisionMaker;
+}
+
+UDecisionMakerComponent* UDMBehaviorTreeComponent::GetDecisionMaker() const
+{
+	return DecisionMaker.Get();
+}
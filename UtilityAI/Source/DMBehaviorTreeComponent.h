@@ -6,6 +6,9 @@
 #include "BehaviorTree/BehaviorTreeComponent.h"
 #include "DMBehaviorTreeComponent.generated.h"
 
+
+class UDecisionMakerComponent;
+
 /**
  * 
  */
@@ -16,4 +19,14 @@ class UTILITYAI_API UDMBehaviorTreeComponent : public UBehaviorTreeComponent
 public:
 
 	void SetLooping(bool bEnabled);
+
+	// Remember which decision maker drives this tree, so tasks don't have to search the controller's components for it
+	void SetDecisionMaker(UDecisionMakerComponent* InDecisionMaker);
+
+	UDecisionMakerComponent* GetDecisionMaker() const;
+
+protected:
+
+	UPROPERTY(Transient)
+	TWeakObjectPtr<UDecisionMakerComponent> DecisionMaker;
 };
@@ -0,0 +1,141 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "DecisionHistory.h"
+#include "DecisionMakerComponent.h"
+
+
+namespace DecisionHistory
+{
+	float GetLatest(const float (&Timestamps)[FDecisionHistoryIndexEntry::NumResults], int32 QueryResultBitmask)
+	{
+		float Latest = -1.f;
+		for (int32 ResultIndex = 0; ResultIndex < FDecisionHistoryIndexEntry::NumResults; ++ResultIndex)
+		{
+			if (TOFLAG(ResultIndex) & QueryResultBitmask)
+				Latest = FMath::Max(Latest, Timestamps[ResultIndex]);
+		}
+		return Latest;
+	}
+}
+
+
+void FDecisionHistory::SetCapacity(int32 NewCapacity)
+{
+	NewCapacity = FMath::Max(NewCapacity, 0);
+	if (NewCapacity == Capacity)
+		return;
+
+	// Unroll the ring, oldest first, keeping as many of the newest records as will fit
+	TArray<FDecisionRecord> Unrolled;
+	const int32 NumToKeep = FMath::Min(NewCapacity, Num());
+	Unrolled.Reserve(NewCapacity);
+	for (int32 Age = NumToKeep - 1; Age >= 0; --Age)
+	{
+		Unrolled.Add(GetRecord(Age));
+	}
+
+	Records = MoveTemp(Unrolled);
+	Capacity = NewCapacity;
+	NextRecordIndex = Capacity > 0 ? Records.Num() % Capacity : 0;
+}
+
+void FDecisionHistory::Add(const FDecisionRecord& Record)
+{
+	const int32 ResultIndex = static_cast<int32>(Record.Result);
+	if (ResultIndex >= 0 && ResultIndex < FDecisionHistoryIndexEntry::NumResults)
+	{
+		FDecisionHistoryIndexEntry& Entry = LatestByOption.FindOrAdd(Record.OptionName);
+		Entry.StartedTimestamps[ResultIndex] = FMath::Max(Entry.StartedTimestamps[ResultIndex], Record.StartedTimestamp);
+		Entry.EndedTimestamps[ResultIndex] = FMath::Max(Entry.EndedTimestamps[ResultIndex], Record.EndedTimestamp);
+	}
+
+	if (Capacity <= 0)
+		return;
+
+	if (Records.Num() < Capacity)
+	{
+		Records.Add(Record);
+	}
+	else
+	{
+		// Full, so overwrite the oldest
+		Records[NextRecordIndex] = Record;
+	}
+	NextRecordIndex = (NextRecordIndex + 1) % Capacity;
+}
+
+void FDecisionHistory::Reset()
+{
+	Records.Reset();
+	LatestByOption.Reset();
+	NextRecordIndex = 0;
+}
+
+const FDecisionRecord& FDecisionHistory::GetRecord(int32 Age) const
+{
+	check(Age >= 0 && Age < Records.Num());
+
+	// The newest record is just behind NextRecordIndex
+	return Records[(NextRecordIndex - 1 - Age + 2 * Records.Num()) % Records.Num()];
+}
+
+float FDecisionHistory::GetLastStartedTimestamp(const FName& OptionName, int32 QueryResultBitmask) const
+{
+	const FDecisionHistoryIndexEntry* Entry = LatestByOption.Find(OptionName);
+	return Entry ? DecisionHistory::GetLatest(Entry->StartedTimestamps, QueryResultBitmask) : -1.f;
+}
+
+float FDecisionHistory::GetLastEndedTimestamp(const FName& OptionName, int32 QueryResultBitmask) const
+{
+	const FDecisionHistoryIndexEntry* Entry = LatestByOption.Find(OptionName);
+	return Entry ? DecisionHistory::GetLatest(Entry->EndedTimestamps, QueryResultBitmask) : -1.f;
+}
+
+SIZE_T FDecisionHistory::GetAllocatedSize() const
+{
+	return Records.GetAllocatedSize() + LatestByOption.GetAllocatedSize();
+}
+
+
+FName AIDecisionHistoryQuery::GetCurrentOptionName(const FDecisionMakerContext& Context)
+{
+	if (Context.DecisionMaker)
+		return Context.DecisionMaker->CurrentDecisionRecord.OptionName;
+
+	return Context.CurrentDecisionRecord ? Context.CurrentDecisionRecord->OptionName : NAME_None;
+}
+
+float AIDecisionHistoryQuery::GetTimeSince(const FDecisionMakerContext& Context, FName OptionName, EDecisionHistoryQueryTime QueryTime, int32 QueryResultBitmask)
+{
+	if (Context.DecisionMaker)
+	{
+		return QueryTime == EDecisionHistoryQueryTime::Started
+			? Context.DecisionMaker->GetTimeSinceStarted(OptionName, QueryResultBitmask)
+			: Context.DecisionMaker->GetTimeSinceEnded(OptionName, QueryResultBitmask);
+	}
+
+	if (!Context.DecisionHistory)
+		return -1.f;
+
+	// No decision maker to ask, so go straight to the history
+	float Timestamp = -1.f;
+	if (QueryTime == EDecisionHistoryQueryTime::Started)
+	{
+		const FDecisionRecord* CurrentRecord = Context.CurrentDecisionRecord;
+		if (CurrentRecord && CurrentRecord->OptionName == OptionName && (TOFLAG(CurrentRecord->Result) & QueryResultBitmask))
+		{
+			Timestamp = CurrentRecord->StartedTimestamp;
+		}
+		else
+		{
+			Timestamp = Context.DecisionHistory->GetLastStartedTimestamp(OptionName, QueryResultBitmask);
+		}
+	}
+	else
+	{
+		Timestamp = Context.DecisionHistory->GetLastEndedTimestamp(OptionName, QueryResultBitmask);
+	}
+
+	return Timestamp >= 0 ? Context.CurrentTime - Timestamp : -1.f;
+}
@@ -0,0 +1,91 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AIShared.h"
+#include "DecisionHistory.generated.h"
+
+
+USTRUCT(BlueprintType)
+struct FDecisionRecord
+{
+	GENERATED_BODY()
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	FName OptionName = FName();
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	float StartedTimestamp = -1;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	float EndedTimestamp = -1;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	EDecisionHistoryQueryResult Result = EDecisionHistoryQueryResult::InProgress;
+};
+
+
+/** Most recent timestamps for one option name, for each result */
+struct FDecisionHistoryIndexEntry
+{
+	static constexpr int32 NumResults = 4;
+
+	float StartedTimestamps[NumResults] = { -1.f, -1.f, -1.f, -1.f };
+
+	float EndedTimestamps[NumResults] = { -1.f, -1.f, -1.f, -1.f };
+};
+
+
+/**
+ * Fixed-capacity ring buffer of finished decisions, plus an index of the latest timestamps per option name and result.
+ * Queries go through the index, so they don't depend on how many records are kept.
+ */
+USTRUCT(BlueprintType)
+struct UTILITYAI_API FDecisionHistory
+{
+	GENERATED_BODY()
+
+	// Change how many records are kept. Keeps the newest ones. 0 keeps no records, but queries still work.
+	void SetCapacity(int32 NewCapacity);
+
+	int32 GetCapacity() const { return Capacity; }
+
+	void Add(const FDecisionRecord& Record);
+
+	void Reset();
+
+	int32 Num() const { return Records.Num(); }
+
+	// 0 is the newest record
+	const FDecisionRecord& GetRecord(int32 Age) const;
+
+	// Timestamp of the most recent start/end of OptionName with a result in QueryResultBitmask. -1 if there isn't one.
+	float GetLastStartedTimestamp(const FName& OptionName, int32 QueryResultBitmask) const;
+	float GetLastEndedTimestamp(const FName& OptionName, int32 QueryResultBitmask) const;
+
+	SIZE_T GetAllocatedSize() const;
+
+protected:
+
+	UPROPERTY(VisibleAnywhere, Category = "DecisionHistory")
+	TArray<FDecisionRecord> Records;
+
+	// Where the next record goes once the buffer is full
+	int32 NextRecordIndex = 0;
+
+	int32 Capacity = 0;
+
+	TMap<FName, FDecisionHistoryIndexEntry> LatestByOption;
+};
+
+
+namespace AIDecisionHistoryQuery
+{
+	// Name of the option the agent in the context is running
+	UTILITYAI_API FName GetCurrentOptionName(const FDecisionMakerContext& Context);
+
+	// Seconds since OptionName last started or ended with a result in QueryResultBitmask. Asks the decision maker if there is one,
+	// otherwise reads the history in the context. -1 if it never has.
+	UTILITYAI_API float GetTimeSince(const FDecisionMakerContext& Context, FName OptionName, EDecisionHistoryQueryTime QueryTime, int32 QueryResultBitmask);
+}
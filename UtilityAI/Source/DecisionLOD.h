@@ -0,0 +1,28 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "DecisionLOD.generated.h"
+
+
+class UAIOptionSetDataAsset;
+
+/** How often (and with which options) an agent decides while it's within a certain distance of the nearest player */
+USTRUCT(BlueprintType)
+struct FDecisionLODTier
+{
+	GENERATED_BODY()
+
+	/** This tier is used while the agent's relevance distance is at most this far. Agents beyond the last tier use the last tier. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (ClampMin = "0"))
+	float MaxRelevanceDistance = 0.f;
+
+	/** Decisions per second in this tier, replacing the decision maker's DecisionRate. 0 means decide every frame. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (ClampMin = "0"))
+	float DecisionRate = 0.f;
+
+	/** If set, only these option sets are evaluated in this tier, instead of BaseOptionSets. Use a cheaper subset for far away agents. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	TArray<UAIOptionSetDataAsset*> OptionSets;
+};
@@ -0,0 +1,1561 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "DecisionMakerComponent.h"
+#include "AIOptionSetDataAsset.h"
+#include "AIOption.h"
+#include "AIConsideration.h"
+#include "AIController.h"
+#include "GameFramework/PlayerController.h"
+#include "DMBehaviorTreeComponent.h"
+#include "UtilityAISubsystem.h"
+#include "UtilityAIStats.h"
+#include "BehaviorTree/BlackboardComponent.h"
+#include "BehaviorTree/BehaviorTreeManager.h"
+#include "Perception/AIPerceptionComponent.h"
+
+#include "VisualLogger/VisualLogger.h"
+#include "Async/ParallelFor.h"
+#include "Misc/App.h"
+#include "Misc/Paths.h"
+#include "UObject/UObjectIterator.h"
+
+#include <atomic>
+
+
+TAutoConsoleVariable<int32> CVarUtilityAIParallelScoring(
+	TEXT("UtilityAI.ParallelScoring"),
+	1,
+	TEXT("Score options with thread-safe considerations on worker threads.\n")
+	TEXT("  0: off\n")
+	TEXT("  1: on\n")
+);
+
+TAutoConsoleVariable<int32> CVarUtilityAIParallelScoringMinOptions(
+	TEXT("UtilityAI.ParallelScoringMinOptions"),
+	8,
+	TEXT("Don't bother going wide unless a decision maker has at least this many options.\n")
+);
+
+static FAutoConsoleCommandWithWorldAndArgs StartRecordingCommand(
+	TEXT("UtilityAI.StartRecording"),
+	TEXT("Start recording decisions. Records every decision maker, or only the one whose owner is named in the first argument."),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		for (TObjectIterator<UDecisionMakerComponent> It; It; ++It)
+		{
+			if (It->GetWorld() == World && It->GetOwner() && (Args.Num() == 0 || It->GetOwner()->GetName() == Args[0]))
+			{
+				It->StartRecording();
+			}
+		}
+	}));
+
+static FAutoConsoleCommandWithWorld StopRecordingCommand(
+	TEXT("UtilityAI.StopRecording"),
+	TEXT("Stop recording decisions, and save a recording per decision maker to Saved/UtilityAI/Recordings"),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+	{
+		for (TObjectIterator<UDecisionMakerComponent> It; It; ++It)
+		{
+			if (It->GetWorld() == World && It->IsRecording())
+			{
+				It->StopRecording(FString());
+			}
+		}
+	}));
+
+static FAutoConsoleCommandWithWorldArgsAndOutputDevice MemoryReportCommand(
+	TEXT("UtilityAI.MemoryReport"),
+	TEXT("Print how much memory decision makers use per agent, and how much option data they share. Pass Agents to list every decision maker."),
+	FConsoleCommandWithWorldArgsAndOutputDeviceDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World, FOutputDevice& Ar)
+	{
+		const bool bListAgents = Args.Contains(TEXT("Agents"));
+
+		int32 NumDecisionMakers = 0;
+		SIZE_T TotalBytes = 0;
+		SIZE_T MaxBytes = 0;
+		const UDecisionMakerComponent* Largest = nullptr;
+		TSet<const FAICompiledOptionSet*> CompiledOptionSets;
+		SIZE_T CompiledOptionSetBytes = 0;
+
+		for (TObjectIterator<UDecisionMakerComponent> It; It; ++It)
+		{
+			if (It->GetWorld() != World)
+				continue;
+
+			const SIZE_T Bytes = It->GetClass()->GetStructureSize() + It->GetDecisionStateAllocatedSize();
+			++NumDecisionMakers;
+			TotalBytes += Bytes;
+
+			if (Bytes > MaxBytes)
+			{
+				MaxBytes = Bytes;
+				Largest = *It;
+			}
+
+			if (const FAISortedOptionList* SortedOptionList = It->GetSortedOptionList())
+			{
+				for (const TSharedRef<const FAICompiledOptionSet>& Source : SortedOptionList->Sources)
+				{
+					bool bAlreadyCounted = false;
+					CompiledOptionSets.Add(&Source.Get(), &bAlreadyCounted);
+					if (!bAlreadyCounted)
+					{
+						CompiledOptionSetBytes += sizeof(FAICompiledOptionSet) + Source->GetAllocatedSize();
+					}
+				}
+			}
+
+			if (bListAgents)
+			{
+				Ar.Logf(TEXT("  %s: %llu bytes"), *GetNameSafe(It->GetOwner()), (uint64)Bytes);
+			}
+		}
+
+		Ar.Logf(TEXT("%d decision makers, %llu bytes total"), NumDecisionMakers, (uint64)TotalBytes);
+		if (NumDecisionMakers > 0)
+		{
+			Ar.Logf(TEXT("Per agent: %llu bytes on average, %llu at most (%s)"),
+				(uint64)(TotalBytes / NumDecisionMakers), (uint64)MaxBytes, *GetNameSafe(Largest ? Largest->GetOwner() : nullptr));
+		}
+
+		int32 NumSortedOptionLists = 0;
+		SIZE_T SortedOptionListBytes = 0;
+		FAISortedOptionList::GetSharedStats(NumSortedOptionLists, SortedOptionListBytes);
+
+		Ar.Logf(TEXT("Shared: %d compiled option sets (%llu bytes), %d sorted option lists (%llu bytes)"),
+			CompiledOptionSets.Num(), (uint64)CompiledOptionSetBytes, NumSortedOptionLists, (uint64)SortedOptionListBytes);
+	}));
+
+static FAutoConsoleCommandWithWorldArgsAndOutputDevice TopCommand(
+	TEXT("UtilityAI.Top"),
+	TEXT("Print the option sets, considerations and agents that take the most decision time. The first argument is how many of each to print (default 10)."),
+	FConsoleCommandWithWorldArgsAndOutputDeviceDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World, FOutputDevice& Ar)
+	{
+		const int32 MaxRows = Args.Num() > 0 ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 10;
+
+		FAIDecisionMetrics::Get().Dump(Ar);
+		FAIDecisionMetrics::Get().DumpTopOptionSets(MaxRows, Ar);
+
+		TArray<FAIConsiderationTimings::FClassTimings> ConsiderationTimings;
+		FAIConsiderationTimings::Get().GetTimings(ConsiderationTimings);
+		if (ConsiderationTimings.Num() > 0)
+		{
+			Ar.Logf(TEXT("%-64s %10s %10s %10s"), TEXT("Considerations"), TEXT("Count"), TEXT("Total ms"), TEXT("Avg us"));
+			for (int32 Index = 0; Index < ConsiderationTimings.Num() && Index < MaxRows; ++Index)
+			{
+				const FAIConsiderationTimings::FClassTimings& ClassTimings = ConsiderationTimings[Index];
+				Ar.Logf(TEXT("%-64s %10llu %10.3f %10.3f"),
+					*ClassTimings.ClassName,
+					ClassTimings.Count,
+					ClassTimings.TotalSeconds * 1000.0,
+					ClassTimings.Count > 0 ? ClassTimings.TotalSeconds * 1.e6 / ClassTimings.Count : 0.0);
+			}
+		}
+		else
+		{
+			Ar.Logf(TEXT("No consideration timings. Set UtilityAI.CollectTimings 1 to collect them."));
+		}
+
+		TArray<const UDecisionMakerComponent*> DecisionMakers;
+		for (TObjectIterator<UDecisionMakerComponent> It; It; ++It)
+		{
+			if (It->GetWorld() == World)
+			{
+				DecisionMakers.Add(*It);
+			}
+		}
+
+		DecisionMakers.Sort([](const UDecisionMakerComponent& A, const UDecisionMakerComponent& B)
+		{
+			return A.GetMetrics().TotalDecisionSeconds > B.GetMetrics().TotalDecisionSeconds;
+		});
+
+		Ar.Logf(TEXT("%-64s %10s %10s %10s %10s %10s  %s"), TEXT("Agents"), TEXT("Decisions"), TEXT("Total ms"), TEXT("Avg us"), TEXT("Switches"), TEXT("Restarts"), TEXT("Option"));
+		for (int32 Index = 0; Index < DecisionMakers.Num() && Index < MaxRows; ++Index)
+		{
+			const UDecisionMakerComponent* DecisionMaker = DecisionMakers[Index];
+			const FDecisionMakerMetrics& Metrics = DecisionMaker->GetMetrics();
+			const UAIOption* CurrentOption = DecisionMaker->GetCurrentOption();
+			Ar.Logf(TEXT("%-64s %10u %10.3f %10.3f %10u %10u  %s"),
+				*GetNameSafe(DecisionMaker->GetOwner()),
+				Metrics.Decisions,
+				Metrics.TotalDecisionSeconds * 1000.0,
+				Metrics.Decisions > 0 ? Metrics.TotalDecisionSeconds * 1.e6 / Metrics.Decisions : 0.0,
+				Metrics.OptionSwitches,
+				Metrics.TreeRestarts,
+				CurrentOption ? *CurrentOption->OptionName.ToString() : TEXT("None"));
+		}
+	}));
+
+static FAutoConsoleCommandWithWorldArgsAndOutputDevice DumpCommand(
+	TEXT("UtilityAI.Dump"),
+	TEXT("Print the state of the decision maker whose owner (or pawn) is named in the first argument: current option, last scores, cooldowns and history"),
+	FConsoleCommandWithWorldArgsAndOutputDeviceDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World, FOutputDevice& Ar)
+	{
+		if (Args.Num() == 0)
+		{
+			Ar.Logf(TEXT("Usage: UtilityAI.Dump <agent name>"));
+			return;
+		}
+
+		bool bFound = false;
+		for (TObjectIterator<UDecisionMakerComponent> It; It; ++It)
+		{
+			if (It->GetWorld() != World || !It->GetOwner())
+				continue;
+
+			const AAIController* AIController = Cast<AAIController>(It->GetOwner());
+			const APawn* Pawn = AIController ? AIController->GetPawn() : nullptr;
+			if (It->GetOwner()->GetName() == Args[0] || (Pawn && Pawn->GetName() == Args[0]))
+			{
+				It->DumpDecisionState(Ar);
+				bFound = true;
+			}
+		}
+
+		if (!bFound)
+		{
+			Ar.Logf(TEXT("No decision maker found for %s"), *Args[0]);
+		}
+	}));
+
+UDecisionMakerComponent::UDecisionMakerComponent()
+{
+	// Decisions are run by the UtilityAISubsystem, so we don't need our own tick
+	PrimaryComponentTick.bCanEverTick = false;
+
+}
+
+void UDecisionMakerComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	DecisionHistory.SetCapacity(DecisionHistoryCapacity);
+}
+
+void UDecisionMakerComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UUtilityAISubsystem* Subsystem = GetUtilityAISubsystem())
+	{
+		Subsystem->UnregisterDecisionMaker(this);
+	}
+	bIsRunning = false;
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void UDecisionMakerComponent::Start()
+{
+	AIOptionSelectedEvent.AddUniqueDynamic(this, &UDecisionMakerComponent::OnAIOptionSelected);
+	AIOptionBehaviorStartedEvent.AddUniqueDynamic(this, &UDecisionMakerComponent::OnAIOptionBehaviorStarted);
+	AIOptionBehaviorEndedEvent.AddUniqueDynamic(this, &UDecisionMakerComponent::OnAIOptionBehaviorEnded);
+
+	// Make sure the AI controller has the right behavior tree component class
+	SpawnDMBehaviorTreeComp();
+
+	// We want the behavior tree to use SingleRun so it doesn't keep repeating the selected option
+	if (UDMBehaviorTreeComponent* BehaviorTreeComp = GetDMBehaviorTreeComp())
+	{
+		BehaviorTreeComp->SetDecisionMaker(this);
+
+		if (BT_OptionTree)
+			BehaviorTreeComp->StartTree(*BT_OptionTree, EBTExecutionMode::SingleRun);
+		
+	}
+
+	bIsRunning = true;
+
+	// A generated seed stays in the stream, so RandomSeed is still 0 and the next Start picks a new one
+	RandomStream.Initialize(RandomSeed != 0 ? RandomSeed : FMath::Rand());
+
+	if (UpdateMode == EDecisionMakerUpdateMode::EventDriven)
+	{
+		StartObservingEvents();
+
+		// We need something to do before we can wait for events
+		RequestDecision();
+	}
+	else
+	{
+		// Spread the first decision over one interval so agents that start together don't all decide on the same frame
+		NextDecisionTime = GetWorld()->GetTimeSeconds() + RandomStream.FRand() * GetDecisionInterval();
+	}
+
+	// Same for LOD updates
+	NextLODUpdateTime = GetWorld()->GetTimeSeconds() + RandomStream.FRand() * LODUpdateInterval;
+
+	if (!AreLODTiersSorted())
+	{
+		UE_LOG(LogDM, Warning, TEXT("%s has LOD tiers whose MaxRelevanceDistance doesn't go up from one tier to the next. Later tiers may never be used."), *GetOwner()->GetName());
+	}
+
+	if (UUtilityAISubsystem* Subsystem = GetUtilityAISubsystem())
+	{
+		Subsystem->RegisterDecisionMaker(this);
+	}
+
+}
+
+void UDecisionMakerComponent::Stop()
+{
+	AIOptionSelectedEvent.RemoveDynamic(this, &UDecisionMakerComponent::OnAIOptionSelected);
+	AIOptionBehaviorStartedEvent.RemoveDynamic(this, &UDecisionMakerComponent::OnAIOptionBehaviorStarted);
+	AIOptionBehaviorEndedEvent.RemoveDynamic(this, &UDecisionMakerComponent::OnAIOptionBehaviorEnded);
+
+	if (UDMBehaviorTreeComponent* BehaviorTreeComp = GetDMBehaviorTreeComp())
+	{
+		BehaviorTreeComp->StopTree();
+	}
+
+	StopObservingEvents();
+
+	bIsRunning = false;
+
+	if (UUtilityAISubsystem* Subsystem = GetUtilityAISubsystem())
+	{
+		Subsystem->UnregisterDecisionMaker(this);
+	}
+
+}
+
+void UDecisionMakerComponent::SetPaused(bool bPaused)
+{
+	if (bPaused)
+	{
+		// Pause the tree
+		if (UDMBehaviorTreeComponent* BehaviorTreeComp = GetDMBehaviorTreeComp())
+		{
+			BehaviorTreeComp->PauseLogic(FString("DecisionMaker asked to pause"));
+		}
+
+		// Stop moving
+		AAIController* AIController = Cast<AAIController>(GetOwner());
+		if (AIController)
+		{
+			AIController->StopMovement();
+		}
+
+		// Stop making decisions. The subsystem will skip us until we resume.
+		bIsPaused = true;
+	}
+	else
+	{
+		if (UDMBehaviorTreeComponent* BehaviorTreeComp = GetDMBehaviorTreeComp())
+		{
+			BehaviorTreeComp->ResumeLogic(FString("DecisionMaker asked to resume"));
+		}
+
+		// Resume making decisions
+		bIsPaused = false;
+	}
+}
+
+float UDecisionMakerComponent::GetDecisionInterval() const
+{
+	if (UpdateMode == EDecisionMakerUpdateMode::EventDriven)
+	{
+		// Events call RequestDecision, which brings the next decision forward
+		return MaxDecisionInterval > 0 ? MaxDecisionInterval : TNumericLimits<float>::Max();
+	}
+
+	const FDecisionLODTier* LODTier = GetCurrentLODTierSettings();
+	const float Rate = LODTier ? LODTier->DecisionRate : DecisionRate;
+
+	return Rate > 0 ? 1.f / Rate : 0.f;
+}
+
+bool UDecisionMakerComponent::IsDecisionDue(double CurrentTime) const
+{
+	return bIsRunning && !bIsPaused && CurrentTime >= NextDecisionTime;
+}
+
+void UDecisionMakerComponent::ScheduleNextDecision(double CurrentTime)
+{
+	NextDecisionTime = CurrentTime + GetDecisionInterval();
+}
+
+void UDecisionMakerComponent::RequestDecision()
+{
+	NextDecisionTime = 0;
+}
+
+void UDecisionMakerComponent::SetDecisionGroup(FName NewGroupName)
+{
+	if (NewGroupName == DecisionGroupName)
+		return;
+
+	// Only decision makers registered with the subsystem are in a group
+	UUtilityAISubsystem* Subsystem = bIsRunning ? GetUtilityAISubsystem() : nullptr;
+	if (Subsystem)
+	{
+		Subsystem->LeaveDecisionGroup(this);
+	}
+
+	DecisionGroupName = NewGroupName;
+
+	if (Subsystem)
+	{
+		Subsystem->JoinDecisionGroup(this);
+	}
+}
+
+float UDecisionMakerComponent::GetRelevanceDistance_Implementation() const
+{
+	const AAIController* AIController = Cast<AAIController>(GetOwner());
+	const APawn* Pawn = AIController ? AIController->GetPawn() : nullptr;
+	UWorld* World = GetWorld();
+	if (!Pawn || !World)
+		return TNumericLimits<float>::Max();
+
+	const FVector PawnLocation = Pawn->GetActorLocation();
+	float NearestDistance = TNumericLimits<float>::Max();
+
+	for (FConstPlayerControllerIterator It = World->GetPlayerControllerIterator(); It; ++It)
+	{
+		const APlayerController* PlayerController = It->Get();
+		if (!PlayerController)
+			continue;
+
+		FVector ViewLocation;
+		FRotator ViewRotation;
+		PlayerController->GetPlayerViewPoint(ViewLocation, ViewRotation);
+
+		float Distance = static_cast<float>(FVector::Dist(PawnLocation, ViewLocation));
+
+		// Only trace if this player could be the nearest one
+		if (OutOfSightDistanceMultiplier > 1.f && Distance < NearestDistance && !PlayerController->LineOfSightTo(Pawn, ViewLocation))
+		{
+			Distance *= OutOfSightDistanceMultiplier;
+		}
+
+		NearestDistance = FMath::Min(NearestDistance, Distance);
+	}
+
+	return NearestDistance;
+}
+
+void UDecisionMakerComponent::UpdateLOD(double CurrentTime)
+{
+	if (LODTiers.Num() == 0 || bLODTierOverridden || CurrentTime < NextLODUpdateTime)
+		return;
+
+	NextLODUpdateTime = CurrentTime + LODUpdateInterval;
+
+	ApplyLODTier(SelectLODTier(GetRelevanceDistance()));
+}
+
+void UDecisionMakerComponent::SetLODTier(int32 NewTier)
+{
+	bLODTierOverridden = true;
+	ApplyLODTier(NewTier);
+}
+
+void UDecisionMakerComponent::ClearLODTierOverride()
+{
+	if (!bLODTierOverridden)
+		return;
+
+	bLODTierOverridden = false;
+	NextLODUpdateTime = 0;
+}
+
+void UDecisionMakerComponent::ApplyLODTier(int32 NewTier)
+{
+	NewTier = LODTiers.Num() > 0 ? FMath::Clamp(NewTier, 0, LODTiers.Num() - 1) : INDEX_NONE;
+	if (NewTier == CurrentLODTier)
+		return;
+
+	const float OldInterval = GetDecisionInterval();
+	CurrentLODTier = NewTier;
+
+	// The new tier might use different option sets
+	MarkOptionSetsDirty();
+
+	// Moving to a faster tier shouldn't have to wait out the slow tier's interval
+	const float NewInterval = GetDecisionInterval();
+	if (NewInterval < OldInterval && UpdateMode == EDecisionMakerUpdateMode::Continuous)
+	{
+		NextDecisionTime = FMath::Min(NextDecisionTime, GetWorld()->GetTimeSeconds() + NewInterval);
+	}
+}
+
+int32 UDecisionMakerComponent::SelectLODTier(float RelevanceDistance) const
+{
+	if (LODTiers.Num() == 0)
+		return INDEX_NONE;
+
+	int32 NewTier = LODTiers.Num() - 1;
+	for (int32 Tier = 0; Tier < LODTiers.Num(); ++Tier)
+	{
+		if (RelevanceDistance <= LODTiers[Tier].MaxRelevanceDistance)
+		{
+			NewTier = Tier;
+			break;
+		}
+	}
+
+	if (!LODTiers.IsValidIndex(CurrentLODTier) || NewTier == CurrentLODTier)
+		return NewTier;
+
+	// Stay put unless we're clear of the boundary we'd be crossing
+	if (NewTier > CurrentLODTier)
+	{
+		if (RelevanceDistance <= LODTiers[CurrentLODTier].MaxRelevanceDistance + LODHysteresisDistance)
+			return CurrentLODTier;
+	}
+	else
+	{
+		if (RelevanceDistance > LODTiers[CurrentLODTier - 1].MaxRelevanceDistance - LODHysteresisDistance)
+			return CurrentLODTier;
+	}
+
+	return NewTier;
+}
+
+const FDecisionLODTier* UDecisionMakerComponent::GetCurrentLODTierSettings() const
+{
+	return LODTiers.IsValidIndex(CurrentLODTier) ? &LODTiers[CurrentLODTier] : nullptr;
+}
+
+bool UDecisionMakerComponent::AreLODTiersSorted() const
+{
+	for (int32 Tier = 1; Tier < LODTiers.Num(); ++Tier)
+	{
+		if (LODTiers[Tier].MaxRelevanceDistance <= LODTiers[Tier - 1].MaxRelevanceDistance)
+			return false;
+	}
+	return true;
+}
+
+void UDecisionMakerComponent::SetRandomSeed(int32 NewSeed)
+{
+	RandomSeed = NewSeed;
+	RandomStream.Initialize(NewSeed);
+}
+
+FAIOptionSelector UDecisionMakerComponent::GetOptionSelector() const
+{
+	FAIOptionSelector Selector;
+	Selector.Strategy = SelectionStrategy;
+	Selector.MinimumWeightFraction = MinimumWeightFractionForRandomSelection;
+	Selector.SoftmaxTemperature = SoftmaxTemperature;
+	return Selector;
+}
+
+void UDecisionMakerComponent::StartObservingEvents()
+{
+	AAIController* AIController = Cast<AAIController>(GetOwner());
+	if (!AIController)
+		return;
+
+	if (UBlackboardComponent* BlackboardComp = AIController->GetBlackboardComponent())
+	{
+		for (const FName& KeyName : ObservedBlackboardKeys)
+		{
+			const FBlackboard::FKey KeyID = BlackboardComp->GetKeyID(KeyName);
+			if (KeyID == FBlackboard::InvalidKey)
+			{
+				UE_LOG(LogDM, Warning, TEXT("%s can't observe blackboard key %s, it isn't in the blackboard"), *GetOwner()->GetName(), *KeyName.ToString());
+				continue;
+			}
+
+			BlackboardComp->RegisterObserver(KeyID, this, FOnBlackboardChangeNotification::CreateUObject(this, &UDecisionMakerComponent::OnObservedBlackboardKeyChanged));
+		}
+	}
+
+	if (bDecideOnPerceptionUpdate)
+	{
+		if (UAIPerceptionComponent* PerceptionComp = AIController->GetAIPerceptionComponent())
+		{
+			PerceptionComp->OnPerceptionUpdated.AddUniqueDynamic(this, &UDecisionMakerComponent::OnPerceptionUpdated);
+		}
+	}
+}
+
+void UDecisionMakerComponent::StopObservingEvents()
+{
+	AAIController* AIController = Cast<AAIController>(GetOwner());
+	if (!AIController)
+		return;
+
+	if (UBlackboardComponent* BlackboardComp = AIController->GetBlackboardComponent())
+	{
+		BlackboardComp->UnregisterObserversFrom(this);
+	}
+
+	if (UAIPerceptionComponent* PerceptionComp = AIController->GetAIPerceptionComponent())
+	{
+		PerceptionComp->OnPerceptionUpdated.RemoveDynamic(this, &UDecisionMakerComponent::OnPerceptionUpdated);
+	}
+}
+
+UUtilityAISubsystem* UDecisionMakerComponent::GetUtilityAISubsystem() const
+{
+	UWorld* World = GetWorld();
+	return World ? World->GetSubsystem<UUtilityAISubsystem>() : nullptr;
+}
+
+FAIOptionSetSourceHandle UDecisionMakerComponent::AddOptionSetSource(UAIOptionSetDataAsset* OptionSet, int32 Priority)
+{
+	FAIOptionSetSourceHandle Handle;
+	if (!OptionSet)
+		return Handle;
+
+	Handle.Id = NextOptionSetSourceId++;
+
+	// Keep sources sorted by priority. Sources with the same priority stay in the order they were added.
+	const int32 Index = OptionSetSources.IndexOfByPredicate([Priority](const FAIOptionSetSource& Source)
+	{
+		return Source.Priority < Priority;
+	});
+
+	FAIOptionSetSource Source;
+	Source.OptionSet = OptionSet;
+	Source.Priority = Priority;
+	Source.Handle = Handle;
+	OptionSetSources.Insert(Source, Index != INDEX_NONE ? Index : OptionSetSources.Num());
+
+	MarkOptionSetsDirty();
+	return Handle;
+}
+
+bool UDecisionMakerComponent::RemoveOptionSetSource(FAIOptionSetSourceHandle& Handle)
+{
+	const int32 NumRemoved = OptionSetSources.RemoveAll([&Handle](const FAIOptionSetSource& Source)
+	{
+		return Source.Handle == Handle;
+	});
+	Handle.Reset();
+
+	if (NumRemoved == 0)
+		return false;
+
+	MarkOptionSetsDirty();
+	return true;
+}
+
+void UDecisionMakerComponent::MarkOptionSetsDirty()
+{
+	bOptionSetsDirty = true;
+
+	// Let go of the old sets straight away, so their options can be collected once nothing else uses them
+	SortedOptionList.Reset();
+	ScoredOptions.Reset();
+	ScoredRankOptions = TArrayView<const FAIOptionRef>();
+}
+
+void UDecisionMakerComponent::GetOptionSets(TArray<UAIOptionSetDataAsset*>& OutOptionSets)
+{
+	// Far away agents can be limited to a cheaper set of options
+	const FDecisionLODTier* LODTier = GetCurrentLODTierSettings();
+	const TArray<UAIOptionSetDataAsset*>& TierOptionSets = LODTier && LODTier->OptionSets.Num() > 0 ? LODTier->OptionSets : BaseOptionSets;
+	for (UAIOptionSetDataAsset* OptionSet : TierOptionSets)
+	{
+		OutOptionSets.AddUnique(OptionSet);
+	}
+
+	for (const FAIOptionSetSource& Source : OptionSetSources)
+	{
+		OutOptionSets.AddUnique(Source.OptionSet);
+	}
+}
+
+void UDecisionMakerComponent::UpdateOptionSets()
+{
+	SCOPE_CYCLE_COUNTER(STAT_UtilityAI_GatherOptionSets);
+
+	if (bOptionSetsDirty || BaseOptionSets != GatheredBaseOptionSets)
+	{
+		bOptionSetsDirty = false;
+		GatheredBaseOptionSets = BaseOptionSets;
+
+		GatheredOptionSets.Reset();
+		GetOptionSets(GatheredOptionSets);
+
+		UpdateSortedOptions(GatheredOptionSets);
+	}
+#if WITH_EDITOR
+	else
+	{
+		// Assets can be recompiled while they're being edited
+		UpdateSortedOptions(GatheredOptionSets);
+	}
+#endif //WITH_EDITOR
+}
+
+void UDecisionMakerComponent::RunDecisionMaker()
+{
+	ScoreDecision();
+	ApplyDecision();
+}
+
+void UDecisionMakerComponent::ScoreDecision()
+{
+	SCOPE_CYCLE_COUNTER(STAT_UtilityAI_RunDecisionMaker);
+	const double StartSeconds = FPlatformTime::Seconds();
+
+#if ENABLE_VISUAL_LOG
+	if (FVisualLogger::Get().IsRecording())
+	{
+		UE_VLOG_UELOG(GetOwner(), LogDM, Log, TEXT("------------\nRunning DM  %s..."), *GetOwner()->GetName());
+	}
+#endif //ENABLE_VISUAL_LOG
+
+	// Kept for ApplyDecision
+	DecisionContext = FDecisionMakerContext();
+	FDecisionMakerContext& DMContext = DecisionContext;
+	DMContext.DecisionMaker = this;
+	DMContext.AIController = Cast<AAIController>(GetOwner());
+	if(DMContext.AIController)
+		DMContext.Pawn = DMContext.AIController->GetPawn();
+	DMContext.CurrentTime = GetWorld()->GetTimeSeconds();
+	DMContext.ConsiderationCache = &ConsiderationCache;
+	DMContext.Cooldowns = &Cooldowns;
+	DMContext.DecisionGroup = DecisionGroup;
+
+	EvaluationQueryCache.Reset();
+	DMContext.EvaluationQueryCache = &EvaluationQueryCache;
+	if (UUtilityAISubsystem* Subsystem = GetUtilityAISubsystem())
+	{
+		DMContext.FrameQueryCache = &Subsystem->GetFrameQueryCache();
+	}
+
+	UpdateOptionSets();
+
+	if (Recorder)
+	{
+		Recorder->BeginDecision(DMContext.CurrentTime, SortedOptionList->Sources);
+		DMContext.DecisionRecorder = Recorder.Get();
+	}
+
+	// Options are sorted by rank, highest first. Score one rank at a time, and stop at the first rank that has any options with weight.
+	const TArrayView<const FAIOptionRef> SortedOptions = SortedOptionList->Options;
+	float BestWeight = 0.f;
+	ScoredOptions.Reset();
+	ScoredRankOptions = TArrayView<const FAIOptionRef>();
+
+	int32 RankStart = 0;
+	while (RankStart < SortedOptions.Num() && BestWeight <= 0)
+	{
+		const int32 RankEnd = AIOptionRanking::FindRankEnd(SortedOptions, RankStart);
+
+		ScoredRankOptions = MakeArrayView(SortedOptions.GetData() + RankStart, RankEnd - RankStart);
+		ScoredOptions.SetNum(ScoredRankOptions.Num(), EAllowShrinking::No);
+		BestWeight = ScoreOptions(ScoredRankOptions, DMContext, ScoredOptions);
+
+#if ENABLE_VISUAL_LOG
+		if (FVisualLogger::Get().IsRecording())
+		{
+			for (const FAIOptionScore& OptionScore : ScoredOptions)
+			{
+				UE_VLOG_UELOG(GetOwner(), LogDM, Verbose, TEXT("Rank: %f Weight: %f   (%s)%s"),
+					OptionScore.Rank, OptionScore.Weight, *OptionScore.Option->OptionName.ToString(), OptionScore.bPruned ? TEXT(" pruned") : TEXT(""));
+			}
+		}
+#endif //ENABLE_VISUAL_LOG
+
+		RankStart = RankEnd;
+	}
+
+	// A replay with different curves could fall through to the ranks below, so recordings need their scores too
+	if (Recorder)
+	{
+		for (int32 Index = RankStart; Index < SortedOptions.Num(); ++Index)
+		{
+			SortedOptions[Index].OptionSet->ScoreOption(SortedOptions[Index].OptionIndex, DMContext);
+		}
+	}
+
+	ScoredBestWeight = BestWeight;
+
+	PendingDecisionSeconds += FPlatformTime::Seconds() - StartSeconds;
+}
+
+void UDecisionMakerComponent::ApplyDecision()
+{
+	SCOPE_CYCLE_COUNTER(STAT_UtilityAI_RunDecisionMaker);
+	INC_DWORD_STAT(STAT_UtilityAI_Decisions);
+	const double StartSeconds = FPlatformTime::Seconds();
+
+	const FDecisionMakerContext& DMContext = DecisionContext;
+	const float BestWeight = ScoredBestWeight;
+	const UAIOption* PreviousOption = CurrentOption;
+
+	// Switching options can change the option sets, which lets go of the list
+	const TSharedPtr<const FAISortedOptionList> DecisionOptionList = SortedOptionList;
+
+	// At this point we already know the best option, but we might want to randomise a bit
+	int32 SelectedIndex = INDEX_NONE;
+	{
+		SCOPE_CYCLE_COUNTER(STAT_UtilityAI_SelectOption);
+		const int32 SelectionSeed = RandomStream.GetCurrentSeed();
+		SelectedIndex = GetOptionSelector().Select(ScoredOptions, BestWeight, RandomStream);
+
+		if (Recorder)
+		{
+			const FAIOptionScore* SelectedScore = ScoredOptions.IsValidIndex(SelectedIndex) ? &ScoredOptions[SelectedIndex] : nullptr;
+			Recorder->EndDecision(SelectionSeed, SelectedScore ? SelectedScore->Option : nullptr, SelectedScore ? SelectedScore->Weight : 0.f);
+		}
+
+		SelectedIndex = ApplyOptionCommitment(SelectedIndex, ScoredRankOptions, DMContext);
+	}
+
+	if (ScoredOptions.IsValidIndex(SelectedIndex))
+	{
+		const FAIOptionScore SelectedScore = ScoredOptions[SelectedIndex];
+		UAIOption* SelectedOption = SelectedScore.Option;
+
+		SetCurrentTarget(SelectedOption, SelectedScore.Target);
+
+		// Handle switching trees here
+		SetCurrentOption(SelectedOption);
+
+#if ENABLE_VISUAL_LOG
+		if (FVisualLogger::Get().IsRecording())
+		{
+
+			UE_VLOG_UELOG(GetOwner(), LogDM, Log, TEXT("\n---\nSelected (%s) - Rank: %f   Weight: %f   Best: %f\n---"),
+				*SelectedOption->OptionName.ToString(), SelectedScore.Rank, SelectedScore.Weight, BestWeight);
+
+			UE_VLOG_LOCATION(GetOwner(), LogDM, Log, DMContext.Pawn->GetActorLocation(), 50.f, FColor::White, TEXT("%s"),
+				SelectedOption ? *SelectedOption->OptionName.ToString() : *FString("nullptr"));
+
+		}
+#endif //ENABLE_VISUAL_LOG
+
+	}
+	else
+	{
+#if ENABLE_VISUAL_LOG
+		if (FVisualLogger::Get().IsRecording())
+		{
+			UE_VLOG_UELOG(GetOwner(), LogDM, Warning, TEXT("%s Could not find an option!"), *GetOwner()->GetName());
+			UE_VLOG_LOCATION(GetOwner(), LogDM, Warning, DMContext.Pawn->GetActorLocation(), 50.f, FColor::Yellow, TEXT("No option found!"));
+		}
+#endif //ENABLE_VISUAL_LOG
+	}
+
+	// Scoring and switching both count towards the decision's time
+	const double DecisionSeconds = PendingDecisionSeconds + (FPlatformTime::Seconds() - StartSeconds);
+	const bool bSwitchedOption = CurrentOption != PreviousOption;
+	PendingDecisionSeconds = 0;
+
+	++Metrics.Decisions;
+	Metrics.OptionSwitches += bSwitchedOption ? 1 : 0;
+	Metrics.TotalDecisionSeconds += DecisionSeconds;
+	Metrics.LastDecisionSeconds = DecisionSeconds;
+
+	if (FAIDecisionMetrics::IsEnabled() && DecisionOptionList)
+	{
+		FAIDecisionMetrics::Get().AddDecision(DecisionOptionList->Name, DecisionSeconds, bSwitchedOption);
+	}
+}
+
+float UDecisionMakerComponent::ScoreOptions(TArrayView<const FAIOptionRef> Options, const FDecisionMakerContext& DMContext, TArrayView<FAIOptionScore> OutOptionScores)
+{
+	SCOPE_CYCLE_COUNTER(STAT_UtilityAI_ScoreOptions);
+	check(Options.Num() == OutOptionScores.Num());
+
+	// Options can be skipped as soon as their best possible weight falls short of the best weight so far.
+	// The selector tells us how far short an option can be and still get picked.
+	const float PruneFraction = GetOptionSelector().GetPruneFraction();
+	std::atomic<float> BestWeight(0.f);
+
+	auto ScoreOption = [&](int32 Index)
+	{
+		const float MinimumWeight = BestWeight.load(std::memory_order_relaxed) * PruneFraction;
+		const FAIOptionScore& OptionScore = OutOptionScores[Index] = Options[Index].OptionSet->ScoreOption(Options[Index].OptionIndex, DMContext, MinimumWeight);
+
+		float CurrentBest = BestWeight.load(std::memory_order_relaxed);
+		while (OptionScore.Weight > CurrentBest && !BestWeight.compare_exchange_weak(CurrentBest, OptionScore.Weight, std::memory_order_relaxed))
+		{
+		}
+	};
+
+	bool bScoreInParallel = CVarUtilityAIParallelScoring.GetValueOnGameThread() != 0
+		&& Options.Num() >= CVarUtilityAIParallelScoringMinOptions.GetValueOnGameThread()
+		&& FApp::ShouldUseThreadingForPerformance();
+
+#if ENABLE_VISUAL_LOG
+	// Keep everything on the game thread while recording, so the consideration logs are complete
+	if (FVisualLogger::Get().IsRecording())
+	{
+		bScoreInParallel = false;
+	}
+#endif //ENABLE_VISUAL_LOG
+
+	if (!bScoreInParallel)
+	{
+		for (int32 Index = 0; Index < Options.Num(); ++Index)
+		{
+			ScoreOption(Index);
+		}
+		return BestWeight.load(std::memory_order_relaxed);
+	}
+
+	// Split options into those that can run on workers and those that have to stay on the game thread
+	TArray<int32>& ThreadSafeIndices = ThreadSafeOptionIndices;
+	TArray<int32>& GameThreadIndices = GameThreadOptionIndices;
+	ThreadSafeIndices.Reset();
+	GameThreadIndices.Reset();
+	for (int32 Index = 0; Index < Options.Num(); ++Index)
+	{
+		if (Options[Index].IsThreadSafe())
+			ThreadSafeIndices.Add(Index);
+		else
+			GameThreadIndices.Add(Index);
+	}
+
+	// Workers pick up the thread-safe options while the game thread gets through the rest.
+	// Each option writes to its own slot, so there's nothing to merge afterwards.
+	ParallelForWithPreWork(ThreadSafeIndices.Num(),
+		[&](int32 WorkIndex)
+		{
+			FAIScoringThreadScope ScoringThreadScope;
+			ScoreOption(ThreadSafeIndices[WorkIndex]);
+		},
+		[&]()
+		{
+			for (int32 Index : GameThreadIndices)
+			{
+				ScoreOption(Index);
+			}
+		});
+
+	return BestWeight.load(std::memory_order_relaxed);
+}
+
+void UDecisionMakerComponent::UpdateSortedOptions(TArrayView<UAIOptionSetDataAsset* const> OptionSets)
+{
+	// See if anything has changed since last time. Compiled sets are replaced (not modified) when their asset changes.
+	const TArrayView<const TSharedRef<const FAICompiledOptionSet>> SortedSources = SortedOptionList ? MakeArrayView(SortedOptionList->Sources) : TArrayView<const TSharedRef<const FAICompiledOptionSet>>();
+
+	bool bChanged = false;
+	int32 NumSources = 0;
+	for (UAIOptionSetDataAsset* OptionSet : OptionSets)
+	{
+		if (!OptionSet)
+			continue;
+
+		if (!SortedSources.IsValidIndex(NumSources) || SortedSources[NumSources] != OptionSet->GetCompiledOptionSet())
+		{
+			bChanged = true;
+			break;
+		}
+		++NumSources;
+	}
+
+	if (SortedOptionList && !bChanged && NumSources == SortedSources.Num())
+		return;
+
+	TArray<TSharedRef<const FAICompiledOptionSet>, TInlineAllocator<8>> CompiledOptionSets;
+	for (UAIOptionSetDataAsset* OptionSet : OptionSets)
+	{
+		if (OptionSet)
+		{
+			CompiledOptionSets.Add(OptionSet->GetCompiledOptionSet());
+		}
+	}
+
+	// Agents with the same option sets share one sorted list
+	SortedOptionList = FAISortedOptionList::Get(CompiledOptionSets);
+
+	PreloadOptionTrees();
+}
+
+void UDecisionMakerComponent::PreloadOptionTrees()
+{
+	UBehaviorTreeManager* BTManager = UBehaviorTreeManager::GetCurrent(GetWorld());
+	if (!BTManager)
+		return;
+
+	for (const TSharedRef<const FAICompiledOptionSet>& CompiledOptionSet : SortedOptionList->Sources)
+	{
+		for (UBehaviorTree* BehaviorTree : CompiledOptionSet->BehaviorTrees)
+		{
+			if (!BehaviorTree)
+				continue;
+
+			// Trees that are already loaded are just looked up
+			UBTCompositeNode* RootNode = nullptr;
+			uint16 InstanceMemorySize = 0;
+			BTManager->LoadTree(*BehaviorTree, RootNode, InstanceMemorySize);
+		}
+	}
+}
+
+void UDecisionMakerComponent::OnAsyncInputReady(const UAIConsideration* Consideration)
+{
+	// Nothing to update until we've scored at least once
+	if (!bIsRunning || bIsPaused || !Consideration || !SortedOptionList || DecisionContext.DecisionMaker != this)
+		return;
+
+	const bool bWouldSwitchBefore = WouldSwitchOption();
+
+	// Results usually arrive a frame or more after the decision, when the last context's pawn may be dead or unpossessed.
+	// Look the actors up again, and skip the parts that only make sense during a decision.
+	FDecisionMakerContext DMContext = DecisionContext;
+	DMContext.AIController = Cast<AAIController>(GetOwner());
+	DMContext.Pawn = IsValid(DMContext.AIController) ? DMContext.AIController->GetPawn() : nullptr;
+	if (!IsValid(DMContext.Pawn))
+		return;
+
+	DMContext.CurrentTime = GetWorld()->GetTimeSeconds();
+	DMContext.DecisionRecorder = nullptr;
+	DMContext.DecisionGroup = nullptr;
+	DMContext.FrameQueryCache = nullptr;
+	if (UUtilityAISubsystem* Subsystem = GetUtilityAISubsystem())
+	{
+		DMContext.FrameQueryCache = &Subsystem->GetFrameQueryCache();
+	}
+	EvaluationQueryCache.Reset();
+
+	const TArrayView<const FAIOptionRef> SortedOptions = SortedOptionList->Options;
+	const float ScoredRank = ScoredRankOptions.Num() > 0 ? ScoredRankOptions[0].GetRank() : -TNumericLimits<float>::Max();
+	bool bHigherRankHasWeight = false;
+
+	for (int32 Index = 0; Index < SortedOptions.Num(); ++Index)
+	{
+		const FAIOptionRef& OptionRef = SortedOptions[Index];
+
+		// Highest rank first. Ranks below the one we picked from can't win.
+		if (OptionRef.GetRank() < ScoredRank)
+			break;
+
+		if (!OptionRef.OptionSet->UsesConsideration(OptionRef.OptionIndex, Consideration))
+			continue;
+
+		INC_DWORD_STAT(STAT_UtilityAI_AsyncRescores);
+		const FAIOptionScore OptionScore = OptionRef.OptionSet->ScoreOption(OptionRef.OptionIndex, DMContext);
+
+		// ScoredRankOptions is a range of SortedOptions
+		const int32 ScoredIndex = ScoredRankOptions.Num() > 0 ? Index - static_cast<int32>(ScoredRankOptions.GetData() - SortedOptions.GetData()) : INDEX_NONE;
+		if (ScoredOptions.IsValidIndex(ScoredIndex))
+		{
+			ScoredOptions[ScoredIndex] = OptionScore;
+		}
+		else if (OptionScore.Weight > 0)
+		{
+			bHigherRankHasWeight = true;
+		}
+	}
+
+	if (bHigherRankHasWeight || (!bWouldSwitchBefore && WouldSwitchOption()))
+	{
+		RequestDecision();
+	}
+}
+
+bool UDecisionMakerComponent::WouldSwitchOption() const
+{
+	float CurrentWeight = 0.f;
+	float BestOtherWeight = 0.f;
+	for (const FAIOptionScore& OptionScore : ScoredOptions)
+	{
+		if (OptionScore.Option == CurrentOption)
+		{
+			CurrentWeight = OptionScore.Weight;
+		}
+		else
+		{
+			BestOtherWeight = FMath::Max(BestOtherWeight, OptionScore.Weight);
+		}
+	}
+
+	return BestOtherWeight > CurrentWeight * (1.f + OptionSwitchMargin);
+}
+
+int32 UDecisionMakerComponent::ApplyOptionCommitment(int32 SelectedIndex, TArrayView<const FAIOptionRef> RankOptions, const FDecisionMakerContext& DMContext)
+{
+	if (MinimumOptionCommitTime <= 0 && OptionSwitchMargin <= 0)
+		return SelectedIndex;
+
+	// Only matters if we'd be interrupting a different option that's still running
+	if (!ScoredOptions.IsValidIndex(SelectedIndex) || !CurrentOption || ScoredOptions[SelectedIndex].Option == CurrentOption || CurrentDecisionRecord.StartedTimestamp <= 0)
+		return SelectedIndex;
+
+	// The current option has to be in the winning rank to hold on. Higher ranks always interrupt.
+	const int32 CurrentIndex = ScoredOptions.IndexOfByPredicate([this](const FAIOptionScore& OptionScore)
+	{
+		return OptionScore.Option == CurrentOption;
+	});
+	if (CurrentIndex == INDEX_NONE)
+		return SelectedIndex;
+
+	// Pruning only tells us the current option couldn't win. We need its actual weight to compare.
+	FAIOptionScore& CurrentScore = ScoredOptions[CurrentIndex];
+	if (CurrentScore.bPruned)
+	{
+		CurrentScore = RankOptions[CurrentIndex].OptionSet->ScoreOption(RankOptions[CurrentIndex].OptionIndex, DMContext);
+	}
+
+	// Options that are no longer valid don't get to stay
+	if (CurrentScore.Weight <= 0)
+		return SelectedIndex;
+
+	if (DMContext.CurrentTime - CurrentDecisionRecord.StartedTimestamp < MinimumOptionCommitTime)
+		return CurrentIndex;
+
+	if (ScoredOptions[SelectedIndex].Weight < CurrentScore.Weight * (1.f + OptionSwitchMargin))
+		return CurrentIndex;
+
+	return SelectedIndex;
+}
+
+FAIOptionScore UDecisionMakerComponent::CalculateOptionScore(UAIOption* Option, const FDecisionMakerContext& DMContext)
+{
+	if (!Option)
+		return FAIOptionScore();
+
+	// Prefer the sets we're already scoring from, then the option's own asset
+	if (SortedOptionList)
+	{
+		for (const TSharedRef<const FAICompiledOptionSet>& CompiledOptionSet : SortedOptionList->Sources)
+		{
+			const int32 OptionIndex = CompiledOptionSet->FindOptionIndex(Option);
+			if (OptionIndex != INDEX_NONE)
+				return CompiledOptionSet->ScoreOption(OptionIndex, DMContext);
+		}
+	}
+
+	if (UAIOptionSetDataAsset* OptionSet = Option->GetTypedOuter<UAIOptionSetDataAsset>())
+	{
+		TSharedRef<const FAICompiledOptionSet> CompiledOptionSet = OptionSet->GetCompiledOptionSet();
+		const int32 OptionIndex = CompiledOptionSet->FindOptionIndex(Option);
+		if (OptionIndex != INDEX_NONE)
+		{
+			return CompiledOptionSet->ScoreOption(OptionIndex, DMContext);
+		}
+	}
+
+	// Options outside any asset keep a compiled copy of their own
+	return Option->GetCompiledOption()->ScoreOption(0, DMContext);
+}
+
+
+void UDecisionMakerComponent::SetCurrentTarget(UAIOption* Option, AActor* NewTarget)
+{
+	CurrentTarget = NewTarget;
+
+	if (!Option || Option->TargetBlackboardKey.IsNone())
+		return;
+
+	AAIController* AIController = Cast<AAIController>(GetOwner());
+	if (UBlackboardComponent* BlackboardComp = AIController ? AIController->GetBlackboardComponent() : nullptr)
+	{
+		// Only notifies observers if the target changed
+		BlackboardComp->SetValueAsObject(Option->TargetBlackboardKey, NewTarget);
+	}
+}
+
+void UDecisionMakerComponent::SetCurrentOption(UAIOption* NewOption)
+{
+	SCOPE_CYCLE_COUNTER(STAT_UtilityAI_SetCurrentOption);
+
+	// If we picked the option that's currently running (and it hasn't finished yet) then leave it alone
+	if (NewOption == CurrentOption && CurrentDecisionRecord.StartedTimestamp > 0)
+	{
+		return;
+	}
+
+
+	UAIOption* OldOption = CurrentOption;
+	CurrentOption = NewOption;
+
+	if (CurrentOption)
+	{
+		UDMBehaviorTreeComponent* BehaviorTreeComp = GetDMBehaviorTreeComp();
+		if (BehaviorTreeComp)
+		{
+			const bool bSameTreeRunning = OldOption && OldOption->BehaviorTree == CurrentOption->BehaviorTree && CurrentDecisionRecord.StartedTimestamp > 0;
+			if (bReuseRunningTree && bSameTreeRunning)
+			{
+				HandOverRunningTree();
+			}
+			else
+			{
+				INC_DWORD_STAT(STAT_UtilityAI_TreeRestarts);
+				++Metrics.TreeRestarts;
+				if (FAIDecisionMetrics::IsEnabled())
+				{
+					FAIDecisionMetrics::Get().AddTreeRestart();
+				}
+				BehaviorTreeComp->RestartTree();
+			}
+		}
+	}
+
+
+	// AI controller probably wants to listen for this
+	AIOptionSelectedEvent.Broadcast(OldOption, CurrentOption);
+
+
+}
+
+
+void UDecisionMakerComponent::HandOverRunningTree()
+{
+	// The old option didn't get to finish
+	CurrentDecisionRecord.EndedTimestamp = GetWorld()->GetTimeSeconds();
+	CurrentDecisionRecord.Result = EDecisionHistoryQueryResult::Aborted;
+	DecisionHistory.Add(CurrentDecisionRecord);
+	StartRunningOptionCooldown();
+
+	// Same as the tree starting for the new option
+	AIOptionBehaviorStartedEvent.Broadcast();
+}
+
+void UDecisionMakerComponent::StartRunningOptionCooldown()
+{
+	if (const UAIOption* EndedOption = RunningOption.Get())
+	{
+		Cooldowns.Start(EndedOption->GetCooldownName(), CurrentDecisionRecord.EndedTimestamp, EndedOption->GetCooldownTime(CurrentDecisionRecord.Result));
+	}
+	RunningOption.Reset();
+}
+
+UAIOption* UDecisionMakerComponent::GetCurrentOption() const
+{
+	return CurrentOption;
+}
+
+UBehaviorTree* UDecisionMakerComponent::GetCurrentOptionTree() const
+{
+	if (CurrentOption) 
+	{
+		return CurrentOption->BehaviorTree;
+	}
+	return nullptr;
+}
+
+void UDecisionMakerComponent::SpawnDMBehaviorTreeComp()
+{
+	// Don't spawn anything if there already is a DM behavior tree comp
+	if (GetDMBehaviorTreeComp())
+		return;
+
+	// We need this to spawn the correct blackboard
+	if (!BT_OptionTree)
+		return;
+
+	/* This process is copied from AAIController::RunBehaviorTree. 
+		Its spawns a behavior tree component and sets up the blackboard. 
+		I've changed it to spawn a special DMBehaviorTree instead.
+	*/
+	if (AAIController* AICon = Cast<AAIController>(GetOwner()))
+	{
+		bool bSuccess = true;
+
+		UBlackboardComponent* BlackboardComp = AICon->GetBlackboardComponent();
+		if (BT_OptionTree->BlackboardAsset && (BlackboardComp == nullptr || BlackboardComp->IsCompatibleWith(BT_OptionTree->BlackboardAsset) == false))
+		{
+			bSuccess = AICon->UseBlackboard(BT_OptionTree->BlackboardAsset, BlackboardComp);
+		}
+
+		if (bSuccess)
+		{
+			//UE_VLOG(this, LogBehaviorTree, Log, TEXT("RunBehaviorTree: spawning DMBehaviorTreeComponent.."));
+			UDMBehaviorTreeComponent* DMBTComp;
+			DMBTComp = NewObject<UDMBehaviorTreeComponent>(AICon, TEXT("DMBTComponent"));
+			DMBTComp->RegisterComponent();
+
+			// make sure BrainComponent points at the newly created BT component
+			AICon->BrainComponent = DMBTComp;
+		}
+	}
+}
+
+
+UDMBehaviorTreeComponent* UDecisionMakerComponent::GetDMBehaviorTreeComp() const
+{
+	if (AAIController* AICon = Cast<AAIController>(GetOwner()))
+	{
+		return Cast<UDMBehaviorTreeComponent>(AICon->GetBrainComponent());
+	}
+
+	return nullptr;
+}
+
+float UDecisionMakerComponent::GetTimeSinceStarted(const FName& OptionName, int32 QueryResultBitmask) const
+{
+	float CurrentTime = GetWorld()->GetTimeSeconds();
+
+	// check the current decision first
+	if (OptionName == CurrentDecisionRecord.OptionName)
+	{
+		if (TOFLAG(CurrentDecisionRecord.Result) & QueryResultBitmask)
+			return CurrentTime - CurrentDecisionRecord.StartedTimestamp;
+	}
+
+	// History keeps the latest timestamp for each option and result, so there's nothing to search
+	const float StartedTimestamp = DecisionHistory.GetLastStartedTimestamp(OptionName, QueryResultBitmask);
+	if (IsWithinHistoryHorizon(StartedTimestamp, CurrentTime))
+		return CurrentTime - StartedTimestamp;
+
+	return -1.f;
+}
+
+
+float UDecisionMakerComponent::GetTimeSinceEnded(const FName& OptionName, int32 QueryResultBitmask) const
+{
+	float CurrentTime = GetWorld()->GetTimeSeconds();
+
+	const float EndedTimestamp = DecisionHistory.GetLastEndedTimestamp(OptionName, QueryResultBitmask);
+	if (IsWithinHistoryHorizon(EndedTimestamp, CurrentTime))
+		return CurrentTime - EndedTimestamp;
+
+	return -1.f;
+}
+
+void UDecisionMakerComponent::InvalidateConsiderationCache()
+{
+	ConsiderationCache.Reset();
+}
+
+void UDecisionMakerComponent::InvalidateCachedConsideration(UAIConsideration* Consideration)
+{
+	ConsiderationCache.Invalidate(Consideration);
+}
+
+void UDecisionMakerComponent::InvalidateCacheKey(FName CacheKey)
+{
+	ConsiderationCache.InvalidateKey(CacheKey);
+}
+
+void UDecisionMakerComponent::StartCooldown(FName CooldownName, float Duration)
+{
+	Cooldowns.Start(CooldownName, GetWorld()->GetTimeSeconds(), Duration);
+}
+
+void UDecisionMakerComponent::ClearCooldown(FName CooldownName)
+{
+	Cooldowns.Clear(CooldownName);
+}
+
+bool UDecisionMakerComponent::IsOnCooldown(FName CooldownName) const
+{
+	return Cooldowns.IsActive(CooldownName, GetWorld()->GetTimeSeconds());
+}
+
+float UDecisionMakerComponent::GetCooldownRemaining(FName CooldownName) const
+{
+	return Cooldowns.GetRemaining(CooldownName, GetWorld()->GetTimeSeconds());
+}
+
+void UDecisionMakerComponent::StartRecording()
+{
+	Recorder = MakeUnique<FAIDecisionRecorder>(GetOwner()->GetName(), GetOptionSelector());
+}
+
+bool UDecisionMakerComponent::StopRecording(const FString& Filename)
+{
+	if (!Recorder)
+		return false;
+
+	const FString SavePath = Filename.IsEmpty()
+		? FPaths::ProjectSavedDir() / TEXT("UtilityAI") / TEXT("Recordings") / (GetOwner()->GetName() + TEXT(".uaidr"))
+		: Filename;
+
+	const bool bSaved = Recorder->SaveToFile(SavePath);
+	UE_LOG(LogDM, Log, TEXT("%s %d decisions for %s to %s"), bSaved ? TEXT("Saved") : TEXT("Failed to save"), Recorder->GetNumDecisions(), *GetOwner()->GetName(), *SavePath);
+
+	Recorder.Reset();
+	return bSaved;
+}
+
+bool UDecisionMakerComponent::IsRecording() const
+{
+	return Recorder.IsValid();
+}
+
+void UDecisionMakerComponent::GetDecisionHistory(TArray<FDecisionRecord>& OutRecords) const
+{
+	OutRecords.Reset(DecisionHistory.Num());
+	for (int32 Age = 0; Age < DecisionHistory.Num(); ++Age)
+	{
+		OutRecords.Add(DecisionHistory.GetRecord(Age));
+	}
+}
+
+SIZE_T UDecisionMakerComponent::GetDecisionStateAllocatedSize() const
+{
+	SIZE_T Size = ScoredOptions.GetAllocatedSize()
+		+ OptionSetSources.GetAllocatedSize()
+		+ GatheredOptionSets.GetAllocatedSize()
+		+ GatheredBaseOptionSets.GetAllocatedSize()
+		+ ThreadSafeOptionIndices.GetAllocatedSize()
+		+ GameThreadOptionIndices.GetAllocatedSize()
+		+ ConsiderationCache.GetAllocatedSize()
+		+ EvaluationQueryCache.GetAllocatedSize()
+		+ Cooldowns.GetAllocatedSize()
+		+ DecisionHistory.GetAllocatedSize();
+
+	if (Recorder)
+	{
+		Size += sizeof(FAIDecisionRecorder) + Recorder->GetData().GetAllocatedSize();
+	}
+
+	return Size;
+}
+
+void UDecisionMakerComponent::DumpDecisionState(FOutputDevice& Ar) const
+{
+	const double CurrentTime = GetWorld()->GetTimeSeconds();
+	const AAIController* AIController = Cast<AAIController>(GetOwner());
+	const APawn* Pawn = AIController ? AIController->GetPawn() : nullptr;
+
+	Ar.Logf(TEXT("%s (pawn %s)%s%s"), *GetNameSafe(GetOwner()), *GetNameSafe(Pawn),
+		bIsRunning ? TEXT("") : TEXT(" stopped"), bIsPaused ? TEXT(" paused") : TEXT(""));
+
+	Ar.Logf(TEXT("  Current option: %s, target %s, running for %.1f s"),
+		CurrentOption ? *CurrentOption->OptionName.ToString() : TEXT("None"),
+		*GetNameSafe(CurrentTarget),
+		CurrentDecisionRecord.StartedTimestamp > 0 ? CurrentTime - CurrentDecisionRecord.StartedTimestamp : 0.0);
+
+	Ar.Logf(TEXT("  Option sets: %s (%d options)"),
+		SortedOptionList ? *SortedOptionList->Name.ToString() : TEXT("None"),
+		SortedOptionList ? SortedOptionList->Options.Num() : 0);
+
+	Ar.Logf(TEXT("  Interval %.2f s, next decision in %.2f s, LOD tier %d, group %s"),
+		GetDecisionInterval(), FMath::Max(NextDecisionTime - CurrentTime, 0.0), CurrentLODTier,
+		DecisionGroup ? *DecisionGroup->GetName().ToString() : TEXT("None"));
+
+	Ar.Logf(TEXT("  %u decisions, avg %.1f us, last %.1f us, %u option switches, %u tree restarts"),
+		Metrics.Decisions,
+		Metrics.Decisions > 0 ? Metrics.TotalDecisionSeconds * 1.e6 / Metrics.Decisions : 0.0,
+		Metrics.LastDecisionSeconds * 1.e6,
+		Metrics.OptionSwitches, Metrics.TreeRestarts);
+
+	Ar.Logf(TEXT("  Last decision:"));
+	for (const FAIOptionScore& OptionScore : ScoredOptions)
+	{
+		Ar.Logf(TEXT("    %-32s rank %6.2f weight %8.4f%s%s"),
+			OptionScore.Option ? *OptionScore.Option->OptionName.ToString() : TEXT("None"),
+			OptionScore.Rank, OptionScore.Weight,
+			OptionScore.Target ? *FString::Printf(TEXT(" target %s"), *OptionScore.Target->GetName()) : TEXT(""),
+			OptionScore.bPruned ? TEXT(" pruned") : TEXT(""));
+	}
+
+	Ar.Logf(TEXT("  Cooldowns:"));
+	Cooldowns.ForEachActive(CurrentTime, [&Ar](FName CooldownName, float Remaining)
+	{
+		Ar.Logf(TEXT("    %-32s %.1f s"), *CooldownName.ToString(), Remaining);
+	});
+
+	Ar.Logf(TEXT("  History (newest first):"));
+	const UEnum* ResultEnum = StaticEnum<EDecisionHistoryQueryResult>();
+	for (int32 Age = 0; Age < DecisionHistory.Num(); ++Age)
+	{
+		const FDecisionRecord& Record = DecisionHistory.GetRecord(Age);
+		Ar.Logf(TEXT("    %-32s %-10s started %.1f s ago, ran %.1f s"),
+			*Record.OptionName.ToString(),
+			*ResultEnum->GetNameStringByValue((int64)Record.Result),
+			CurrentTime - Record.StartedTimestamp,
+			Record.EndedTimestamp - Record.StartedTimestamp);
+	}
+}
+
+bool UDecisionMakerComponent::IsWithinHistoryHorizon(float Timestamp, float CurrentTime) const
+{
+	if (Timestamp < 0)
+		return false;
+
+	return DecisionHistoryMaxAge <= 0 || CurrentTime - Timestamp <= DecisionHistoryMaxAge;
+}
+
+
+void UDecisionMakerComponent::OnAIOptionSelected(UAIOption* OldOption, UAIOption* NewOption)
+{
+	
+}
+
+void UDecisionMakerComponent::OnAIOptionBehaviorStarted()
+{
+	// Create a new DecisionRecord.  This should be called when an option has started successfully (eg it has a BehaviorTree running)
+	CurrentDecisionRecord = FDecisionRecord();
+	CurrentDecisionRecord.OptionName = CurrentOption != nullptr ? CurrentOption->OptionName : FName();
+	CurrentDecisionRecord.StartedTimestamp = GetWorld()->GetTimeSeconds();
+	CurrentDecisionRecord.Result = EDecisionHistoryQueryResult::InProgress;
+	RunningOption = CurrentOption;
+
+#if ENABLE_VISUAL_LOG
+	if (FVisualLogger::Get().IsRecording())
+	{
+		UE_VLOG_UELOG(GetOwner(), LogDM, Verbose, TEXT("(%s) started %f"),
+			*CurrentDecisionRecord.OptionName.ToString(), CurrentDecisionRecord.StartedTimestamp);
+	}
+#endif //ENABLE_VISUAL_LOG
+}
+
+
+void UDecisionMakerComponent::OnAIOptionBehaviorEnded(EBTNodeResult::Type Result)
+{
+	// Current option is most likely not the option we just finished, so we should leave it alone.
+	// CurrentDecisionRecord should still be relevant though. So we need to push it to history
+
+	// Store results in decision history
+	CurrentDecisionRecord.EndedTimestamp = GetWorld()->GetTimeSeconds();
+	CurrentDecisionRecord.Result =
+		Result == EBTNodeResult::Succeeded ? EDecisionHistoryQueryResult::Succeeded :
+		Result == EBTNodeResult::Failed ? EDecisionHistoryQueryResult::Failed :
+		Result == EBTNodeResult::Aborted ? EDecisionHistoryQueryResult::Aborted :
+		EDecisionHistoryQueryResult::InProgress; // Shouldn't ever pick this one since the tree has finished.
+
+	// Overwrites the oldest record once the history is full
+	DecisionHistory.Add(CurrentDecisionRecord);
+
+	StartRunningOptionCooldown();
+
+#if ENABLE_VISUAL_LOG
+	if (FVisualLogger::Get().IsRecording())
+	{
+		UE_VLOG_UELOG(GetOwner(), LogDM, Verbose, TEXT("(%s) started %f"),
+			*CurrentDecisionRecord.OptionName.ToString(), CurrentDecisionRecord.StartedTimestamp);
+
+		if (Result == EBTNodeResult::Succeeded)
+		{
+			UE_VLOG_UELOG(GetOwner(), LogDM, Verbose, TEXT("(%s) ended %f succesfully"),
+				*CurrentDecisionRecord.OptionName.ToString(), CurrentDecisionRecord.EndedTimestamp);
+		}
+		else if (Result == EBTNodeResult::Failed)
+		{
+			UE_VLOG_UELOG(GetOwner(), LogDM, Verbose, TEXT("(%s) ended %f failed"),
+				*CurrentDecisionRecord.OptionName.ToString(), CurrentDecisionRecord.EndedTimestamp);
+		}
+		else
+		{
+			UE_VLOG_UELOG(GetOwner(), LogDM, Verbose, TEXT("(%s) ended %f aborted"),
+				*CurrentDecisionRecord.OptionName.ToString(), CurrentDecisionRecord.EndedTimestamp);
+		}
+	}
+#endif //ENABLE_VISUAL_LOG
+
+	// Reset this - it's not needed any more.
+	CurrentDecisionRecord = FDecisionRecord();
+
+	// Pick something new straight away instead of waiting for the next scheduled decision
+	RequestDecision();
+
+}
+
+void UDecisionMakerComponent::OnGameplayTagChanged(const FGameplayTag Tag, int32 NewCount)
+{
+	if (UpdateMode == EDecisionMakerUpdateMode::EventDriven && Tag.MatchesAny(ObservedGameplayTags))
+	{
+		RequestDecision();
+	}
+}
+
+void UDecisionMakerComponent::OnPerceptionUpdated(const TArray<AActor*>& UpdatedActors)
+{
+	RequestDecision();
+}
+
+EBlackboardNotificationResult UDecisionMakerComponent::OnObservedBlackboardKeyChanged(const UBlackboardComponent& Blackboard, FBlackboard::FKey ChangedKeyID)
+{
+	RequestDecision();
+
+	return EBlackboardNotificationResult::ContinueObserving;
+}
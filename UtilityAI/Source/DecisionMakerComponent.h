@@ -0,0 +1,535 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "AIShared.h"
+#include "AIOption.h"
+#include "AICompiledOptionSet.h"
+#include "DecisionHistory.h"
+#include "DecisionLOD.h"
+#include "AIOptionSelector.h"
+#include "AIConsiderationCache.h"
+#include "AIQueryCache.h"
+#include "AIDecisionRecording.h"
+#include "AICooldownStore.h"
+#include "BehaviorTree/BehaviorTree.h"
+#include "BehaviorTree/BlackboardComponent.h"
+#include "GameplayTagContainer.h"
+#include "DecisionMakerComponent.generated.h"
+
+
+class UAIOptionSetDataAsset;
+class UDMBehaviorTreeComponent;
+class UAIConsideration;
+class UUtilityAISubsystem;
+class FAIDecisionGroup;
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FAIOptionSelectedEvent, UAIOption*, OldOption, UAIOption*, NewOption);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE(FAIOptionBehaviorStartedEvent);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FAIOptionBehaviorEndedEvent, EBTNodeResult::Type, Result);
+
+
+UENUM(BlueprintType)
+enum class EDecisionMakerUpdateMode : uint8
+{
+	/** Make decisions at DecisionRate */
+	Continuous,
+
+	/** Only make decisions when something happens: the current option ends, an observed blackboard key or gameplay tag changes,
+		perception updates, RequestDecision is called, or MaxDecisionInterval runs out */
+	EventDriven
+};
+
+
+/** Identifies an option set added with AddOptionSetSource, so it can be removed again */
+USTRUCT(BlueprintType)
+struct FAIOptionSetSourceHandle
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	int32 Id = INDEX_NONE;
+
+	bool IsValid() const { return Id != INDEX_NONE; }
+
+	void Reset() { Id = INDEX_NONE; }
+
+	bool operator==(const FAIOptionSetSourceHandle& Other) const { return Id == Other.Id; }
+};
+
+/** An option set added at runtime, eg. by equipment */
+USTRUCT()
+struct FAIOptionSetSource
+{
+	GENERATED_BODY()
+
+	UPROPERTY(VisibleInstanceOnly, Category = "DecisionMaker")
+	UAIOptionSetDataAsset* OptionSet = nullptr;
+
+	UPROPERTY(VisibleInstanceOnly, Category = "DecisionMaker")
+	int32 Priority = 0;
+
+	FAIOptionSetSourceHandle Handle;
+};
+
+/** One agent's share of the decision metrics, for UtilityAI.Top and UtilityAI.Dump */
+struct FDecisionMakerMetrics
+{
+	uint32 Decisions = 0;
+
+	uint32 OptionSwitches = 0;
+
+	uint32 TreeRestarts = 0;
+
+	double TotalDecisionSeconds = 0;
+
+	double LastDecisionSeconds = 0;
+};
+
+
+
+UCLASS( ClassGroup=(Custom), meta=(BlueprintSpawnableComponent) )
+class UTILITYAI_API UDecisionMakerComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+	// Groups score and apply their members' decisions in steps
+	friend class FAIDecisionGroup;
+
+	// Keeps SubsystemIndex up to date
+	friend class UUtilityAISubsystem;
+
+public:
+
+	// This tree shold have a node to run the options from the decision maker
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "TenAIController")
+	UBehaviorTree* BT_OptionTree;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "DecisionMaker")
+	UAIOption* CurrentOption;
+
+	/** Target picked for the current option, if it has a target generator */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "DecisionMaker")
+	AActor* CurrentTarget;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "DecisionMaker")
+	TArray<UAIOptionSetDataAsset*> BaseOptionSets;
+
+	/** How to pick from the highest ranked options that have weight */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "DecisionMaker")
+	EAIOptionSelectionStrategy SelectionStrategy = EAIOptionSelectionStrategy::TopFraction;
+
+	/** Options whose weights are close enough to the best weight can be randomised. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "DecisionMaker", meta = (ClampMin = "0", ClampMax = "1", EditCondition = "SelectionStrategy == EAIOptionSelectionStrategy::TopFraction"))
+	float MinimumWeightFractionForRandomSelection = 0.95f;
+
+	/** Higher temperatures make the Softmax strategy more random. 0 always picks the best option. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "DecisionMaker", meta = (ClampMin = "0", EditCondition = "SelectionStrategy == EAIOptionSelectionStrategy::Softmax"))
+	float SoftmaxTemperature = 1.f;
+
+	/** Seed for this agent's random selections, so decisions can be replayed. 0 picks a new random seed on every Start; GetRandomStream has the one in use. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "DecisionMaker")
+	int32 RandomSeed = 0;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "DecisionMaker|Scheduling")
+	EDecisionMakerUpdateMode UpdateMode = EDecisionMakerUpdateMode::Continuous;
+
+	/** How many decisions to make per second. 0 means decide every frame. Decisions are run by the UtilityAISubsystem. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "DecisionMaker|Scheduling", meta = (ClampMin = "0", EditCondition = "UpdateMode == EDecisionMakerUpdateMode::Continuous"))
+	float DecisionRate = 0.f;
+
+	/** In EventDriven mode, decide anyway if nothing has happened for this many seconds. 0 means only decide on events. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "DecisionMaker|Scheduling", meta = (ClampMin = "0", EditCondition = "UpdateMode == EDecisionMakerUpdateMode::EventDriven"))
+	float MaxDecisionInterval = 5.f;
+
+	/** In EventDriven mode, decide when any of these blackboard keys change */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "DecisionMaker|Scheduling", meta = (EditCondition = "UpdateMode == EDecisionMakerUpdateMode::EventDriven"))
+	TArray<FName> ObservedBlackboardKeys;
+
+	/** In EventDriven mode, decide when any of these tags are passed to OnGameplayTagChanged */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "DecisionMaker|Scheduling", meta = (EditCondition = "UpdateMode == EDecisionMakerUpdateMode::EventDriven"))
+	FGameplayTagContainer ObservedGameplayTags;
+
+	/** Decision makers with the same group name decide together, sharing group considerations and exclusive options. Use SetDecisionGroup to change it while running. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "DecisionMaker|Group")
+	FName DecisionGroupName;
+
+	/** In EventDriven mode, decide when the AI controller's perception component updates */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "DecisionMaker|Scheduling", meta = (EditCondition = "UpdateMode == EDecisionMakerUpdateMode::EventDriven"))
+	bool bDecideOnPerceptionUpdate = true;
+
+	/** Keep running the current option for at least this many seconds before switching to another option of the same rank.
+		Higher ranked options can still interrupt. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "DecisionMaker|Switching", meta = (ClampMin = "0"))
+	float MinimumOptionCommitTime = 0.f;
+
+	/** Another option of the same rank has to beat the current option's weight by this fraction before we switch to it.
+		Stops near-tied options from restarting the tree over and over. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "DecisionMaker|Switching", meta = (ClampMin = "0"))
+	float OptionSwitchMargin = 0.f;
+
+	/** When switching between options that use the same behavior tree, keep the running tree instead of restarting it.
+		Leave this off if your trees read the current option when they start. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "DecisionMaker|Switching")
+	bool bReuseRunningTree = false;
+
+	/** Decision rates (and option subsets) by distance to the nearest player, nearest tier first. Leave empty to always use DecisionRate and BaseOptionSets. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "DecisionMaker|LOD")
+	TArray<FDecisionLODTier> LODTiers;
+
+	/** How often to work out relevance and pick an LOD tier, in seconds */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "DecisionMaker|LOD", meta = (ClampMin = "0"))
+	float LODUpdateInterval = 1.f;
+
+	/** Agents have to go this far past a tier boundary before changing tier, so agents near a boundary don't keep switching */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "DecisionMaker|LOD", meta = (ClampMin = "0"))
+	float LODHysteresisDistance = 200.f;
+
+	/** Distance to players that can't see the pawn is multiplied by this. 1 skips the line of sight checks. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "DecisionMaker|LOD", meta = (ClampMin = "1"))
+	float OutOfSightDistanceMultiplier = 1.f;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "DecisionMaker|LOD")
+	int32 CurrentLODTier = INDEX_NONE;
+	
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "DecisionMaker|History")
+	FDecisionRecord CurrentDecisionRecord;
+
+	UPROPERTY(VisibleAnywhere, Category = "DecisionMaker|History")
+	FDecisionHistory DecisionHistory;
+
+	/** How many finished decisions to keep in DecisionHistory. History queries don't depend on this. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "DecisionMaker|History", meta = (ClampMin = "0"))
+	int32 DecisionHistoryCapacity = 16;
+
+	/** History queries ignore decisions older than this many seconds. 0 means no limit. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "DecisionMaker|History", meta = (ClampMin = "0"))
+	float DecisionHistoryMaxAge = 0.f;
+
+	// --- Events ---
+
+	UPROPERTY(BlueprintAssignable, Category = "DecisionMaker")
+	FAIOptionSelectedEvent AIOptionSelectedEvent;
+
+	UPROPERTY(BlueprintAssignable, Category = "DecisionMaker")
+	FAIOptionBehaviorStartedEvent AIOptionBehaviorStartedEvent;
+
+	UPROPERTY(BlueprintAssignable, Category = "DecisionMaker")
+	FAIOptionBehaviorEndedEvent AIOptionBehaviorEndedEvent;
+
+
+
+public:
+	UDecisionMakerComponent();
+
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	void Start();
+	void Stop();
+
+	// Should pause BTree and decision making without cancelling anything
+	void SetPaused(bool bPaused);
+
+	// --- Scheduling ---
+
+	// Seconds between decisions, based on DecisionRate or the current LOD tier
+	virtual float GetDecisionInterval() const;
+
+	// True if we are running, not paused, and our next decision time has come
+	bool IsDecisionDue(double CurrentTime) const;
+
+	// Called by the subsystem after running the decision maker
+	void ScheduleNextDecision(double CurrentTime);
+
+	// Make a decision as soon as possible (next subsystem update)
+	UFUNCTION(BlueprintCallable, Category = "DecisionMaker")
+	void RequestDecision();
+
+	// --- Groups ---
+
+	// Leave the current decision group (if any) and join another. None leaves without joining.
+	UFUNCTION(BlueprintCallable, Category = "DecisionMaker|Group")
+	void SetDecisionGroup(FName NewGroupName);
+
+	FAIDecisionGroup* GetDecisionGroup() const { return DecisionGroup; }
+
+	// --- LOD ---
+
+	// How relevant this agent is to players, as a distance. By default it's the distance from the pawn to the nearest player's view point.
+	UFUNCTION(BlueprintNativeEvent, BlueprintCallable, Category = "DecisionMaker|LOD")
+	float GetRelevanceDistance() const;
+
+	// Called by the subsystem every frame. Picks a new LOD tier every LODUpdateInterval, unless SetLODTier has locked it.
+	void UpdateLOD(double CurrentTime);
+
+	// Switch LOD tier straight away, eg. when an agent gets involved in combat. The tier stays until ClearLODTierOverride.
+	UFUNCTION(BlueprintCallable, Category = "DecisionMaker|LOD")
+	void SetLODTier(int32 NewTier);
+
+	// Go back to picking the LOD tier by relevance distance, starting with the next update
+	UFUNCTION(BlueprintCallable, Category = "DecisionMaker|LOD")
+	void ClearLODTierOverride();
+
+	UFUNCTION(BlueprintPure, Category = "DecisionMaker|LOD")
+	bool IsLODTierOverridden() const { return bLODTierOverridden; }
+
+	// The LOD tier for a relevance distance, taking LODHysteresisDistance into account
+	int32 SelectLODTier(float RelevanceDistance) const;
+
+	const FDecisionLODTier* GetCurrentLODTierSettings() const;
+
+	// Tiers are searched nearest first, so each MaxRelevanceDistance has to be larger than the one before
+	bool AreLODTiersSorted() const;
+
+	// Restart the random stream used for selection
+	UFUNCTION(BlueprintCallable, Category = "DecisionMaker")
+	void SetRandomSeed(int32 NewSeed);
+
+	const FRandomStream& GetRandomStream() const { return RandomStream; }
+
+	FAIOptionSelector GetOptionSelector() const;
+
+	// --- Option sets ---
+
+	// Evaluate an option set as well as BaseOptionSets until it's removed. Among options of the same rank, BaseOptionSets go first, then sets with a higher priority.
+	UFUNCTION(BlueprintCallable, Category = "DecisionMaker")
+	FAIOptionSetSourceHandle AddOptionSetSource(UAIOptionSetDataAsset* OptionSet, int32 Priority = 0);
+
+	// Stop evaluating an option set added with AddOptionSetSource. Resets the handle.
+	UFUNCTION(BlueprintCallable, Category = "DecisionMaker")
+	bool RemoveOptionSetSource(UPARAM(ref) FAIOptionSetSourceHandle& Handle);
+
+	// Gather option sets again before the next decision. Call this when an override of GetOptionSets would return something different.
+	UFUNCTION(BlueprintCallable, Category = "DecisionMaker")
+	void MarkOptionSetsDirty();
+
+	// The option sets to evaluate: the LOD tier's sets (or BaseOptionSets), then the added sources, without duplicates.
+	// Only called when the option sets are dirty.
+	virtual void GetOptionSets(TArray<UAIOptionSetDataAsset*>& OutOptionSets);
+
+	void RunDecisionMaker();
+
+	// Score each option into the matching slot of OutOptionScores, and return the best weight. Options with thread-safe considerations may be scored on worker threads.
+	float ScoreOptions(TArrayView<const FAIOptionRef> Options, const FDecisionMakerContext& DMContext, TArrayView<FAIOptionScore> OutOptionScores);
+
+	// Score a single option outside of RunDecisionMaker
+	FAIOptionScore CalculateOptionScore(UAIOption* Option, const FDecisionMakerContext& DMContext);
+
+	void SetCurrentOption(UAIOption* NewOption);
+
+	// Remember the option's target and write it to the option's blackboard key. Call before SetCurrentOption so the tree starts with it.
+	void SetCurrentTarget(UAIOption* Option, AActor* NewTarget);
+
+	UFUNCTION(BlueprintCallable, Category = "DecisionMaker")
+	UAIOption* GetCurrentOption() const;
+
+	UFUNCTION(BlueprintCallable, Category = "DecisionMaker")
+	UBehaviorTree* GetCurrentOptionTree() const;
+
+	void SpawnDMBehaviorTreeComp();
+
+	UDMBehaviorTreeComponent* GetDMBehaviorTreeComp() const;
+
+	UFUNCTION(BlueprintCallable, Category = "DecisionMaker")
+	float GetTimeSinceStarted(const FName& OptionName, int32 QueryResultBitmask) const;
+
+	UFUNCTION(BlueprintCallable, Category = "DecisionMaker")
+	float GetTimeSinceEnded(const FName& OptionName, int32 QueryResultBitmask) const;
+
+	// Forget all cached consideration scores
+	UFUNCTION(BlueprintCallable, Category = "DecisionMaker|Caching")
+	void InvalidateConsiderationCache();
+
+	// Forget the cached score for one consideration
+	UFUNCTION(BlueprintCallable, Category = "DecisionMaker|Caching")
+	void InvalidateCachedConsideration(UAIConsideration* Consideration);
+
+	// Forget the cached score shared by considerations with this CacheKey
+	UFUNCTION(BlueprintCallable, Category = "DecisionMaker|Caching")
+	void InvalidateCacheKey(FName CacheKey);
+
+	// --- Cooldowns ---
+
+	// Options with this cooldown name can't be picked for Duration seconds. Use an option's name to lock out just that option.
+	UFUNCTION(BlueprintCallable, Category = "DecisionMaker|Cooldowns")
+	void StartCooldown(FName CooldownName, float Duration);
+
+	UFUNCTION(BlueprintCallable, Category = "DecisionMaker|Cooldowns")
+	void ClearCooldown(FName CooldownName);
+
+	UFUNCTION(BlueprintCallable, Category = "DecisionMaker|Cooldowns")
+	bool IsOnCooldown(FName CooldownName) const;
+
+	UFUNCTION(BlueprintCallable, Category = "DecisionMaker|Cooldowns")
+	float GetCooldownRemaining(FName CooldownName) const;
+
+	// --- Recording ---
+
+	// Record what every decision from now on is based on, so it can be replayed offline with the UtilityAIReplay commandlet
+	UFUNCTION(BlueprintCallable, Category = "DecisionMaker|Recording")
+	void StartRecording();
+
+	// Stop recording and save it. Saves to Saved/UtilityAI/Recordings/<Owner>.uaidr if Filename is empty.
+	UFUNCTION(BlueprintCallable, Category = "DecisionMaker|Recording")
+	bool StopRecording(const FString& Filename);
+
+	UFUNCTION(BlueprintCallable, Category = "DecisionMaker|Recording")
+	bool IsRecording() const;
+
+	// Get the kept decision records, newest first
+	UFUNCTION(BlueprintCallable, Category = "DecisionMaker")
+	void GetDecisionHistory(TArray<FDecisionRecord>& OutRecords) const;
+
+	// --- Memory ---
+
+	// Heap memory held by this agent's own decision state. Doesn't include the option data shared through SortedOptionList.
+	SIZE_T GetDecisionStateAllocatedSize() const;
+
+	const FAISortedOptionList* GetSortedOptionList() const { return SortedOptionList.Get(); }
+
+	// --- Metrics ---
+
+	const FDecisionMakerMetrics& GetMetrics() const { return Metrics; }
+
+	// Print the current option, the last decision's scores, cooldowns and history, for UtilityAI.Dump
+	void DumpDecisionState(FOutputDevice& Ar) const;
+
+	// --- Callbacks ---
+
+	UFUNCTION()
+	void OnAIOptionSelected(UAIOption* OldOption, UAIOption* NewOption);
+
+	UFUNCTION()
+	void OnAIOptionBehaviorStarted();
+
+	UFUNCTION()
+	void OnAIOptionBehaviorEnded(EBTNodeResult::Type Result);
+
+	// Bind this to tag count changes, eg. UAbilitySystemComponent::RegisterGameplayTagEvent
+	void OnGameplayTagChanged(const FGameplayTag Tag, int32 NewCount);
+
+	UFUNCTION()
+	void OnPerceptionUpdated(const TArray<AActor*>& UpdatedActors);
+
+	// An async input read by Consideration has a new value. Re-scores the options that use it, and decides again if one of them would now win.
+	void OnAsyncInputReady(const UAIConsideration* Consideration);
+
+	EBlackboardNotificationResult OnObservedBlackboardKeyChanged(const UBlackboardComponent& Blackboard, FBlackboard::FKey ChangedKeyID);
+
+protected:
+
+	UUtilityAISubsystem* GetUtilityAISubsystem() const;
+
+	// Hook up (or remove) the events that wake us up in EventDriven mode
+	void StartObservingEvents();
+	void StopObservingEvents();
+
+	// Is a history timestamp recent enough to count, according to DecisionHistoryMaxAge?
+	bool IsWithinHistoryHorizon(float Timestamp, float CurrentTime) const;
+
+	// Change to a tier (clamped to LODTiers), applying its decision rate and option sets
+	void ApplyLODTier(int32 NewTier);
+
+	// Gather option sets and get a new SortedOptionList if membership has changed
+	void UpdateOptionSets();
+
+	// Get a new SortedOptionList if the option sets have changed since last time
+	void UpdateSortedOptions(TArrayView<UAIOptionSetDataAsset* const> OptionSets);
+
+	// Load the behavior tree templates of every option we might pick, so switching to one doesn't have to
+	void PreloadOptionTrees();
+
+	// Gather option sets and score them into ScoredOptions, without acting on the result
+	void ScoreDecision();
+
+	// Select from ScoredOptions and switch to the selected option. Must follow ScoreDecision.
+	void ApplyDecision();
+
+	// Would a new decision pick something other than the current option, going by ScoredOptions?
+	bool WouldSwitchOption() const;
+
+	// Keep the current option if MinimumOptionCommitTime or OptionSwitchMargin say so. RankOptions are the options ScoredOptions were scored from.
+	int32 ApplyOptionCommitment(int32 SelectedIndex, TArrayView<const FAIOptionRef> RankOptions, const FDecisionMakerContext& DMContext);
+
+	// Let the current option take over the running tree from the previous option, which used the same tree
+	void HandOverRunningTree();
+
+	// Start the cooldown of the option that just ended, for CurrentDecisionRecord's result
+	void StartRunningOptionCooldown();
+
+	// All options from our option sets, sorted by rank. Shared with other agents using the same sets.
+	TSharedPtr<const FAISortedOptionList> SortedOptionList;
+
+	// Scores for the rank being evaluated. Kept between decisions so it doesn't need reallocating.
+	TArray<FAIOptionScore> ScoredOptions;
+
+	// The options ScoredOptions was scored from, and the best weight among them. Set by ScoreDecision.
+	TArrayView<const FAIOptionRef> ScoredRankOptions;
+
+	float ScoredBestWeight = 0.f;
+
+	// Context of the last ScoreDecision
+	FDecisionMakerContext DecisionContext;
+
+	// Set while we're a member of a decision group. Owned by the UtilityAISubsystem.
+	FAIDecisionGroup* DecisionGroup = nullptr;
+
+	// Where we are in the UtilityAISubsystem's list of decision makers, or INDEX_NONE if we're not registered
+	int32 SubsystemIndex = INDEX_NONE;
+
+	// Option sets added with AddOptionSetSource, highest priority first
+	UPROPERTY(VisibleInstanceOnly, Transient, Category = "DecisionMaker")
+	TArray<FAIOptionSetSource> OptionSetSources;
+
+	int32 NextOptionSetSourceId = 0;
+
+	// The option sets SortedOptionList was built from
+	TArray<UAIOptionSetDataAsset*> GatheredOptionSets;
+
+	// BaseOptionSets as they were when we last gathered, since they can be changed without telling us
+	TArray<UAIOptionSetDataAsset*> GatheredBaseOptionSets;
+
+	bool bOptionSetsDirty = true;
+
+	// --- Scratch buffers. Only used during RunDecisionMaker, and kept so a decision doesn't need to allocate once they've grown. ---
+
+	TArray<int32> ThreadSafeOptionIndices;
+
+	TArray<int32> GameThreadOptionIndices;
+
+	FRandomStream RandomStream;
+
+	// Scores of considerations with a CacheTimeToLive
+	FAIConsiderationCache ConsiderationCache;
+
+	// Query results for the decision being made
+	FAIQueryCache EvaluationQueryCache;
+
+	// Cooldowns started by StartCooldown and by options ending
+	FAICooldownStore Cooldowns;
+
+	// The option whose behavior is running, so its cooldown can be started when it ends
+	TWeakObjectPtr<UAIOption> RunningOption;
+
+	// Set between StartRecording and StopRecording
+	TUniquePtr<FAIDecisionRecorder> Recorder;
+
+	bool bIsRunning = false;
+
+	bool bIsPaused = false;
+
+	double NextDecisionTime = 0;
+
+	double NextLODUpdateTime = 0;
+
+	// Set by SetLODTier so UpdateLOD leaves the tier alone
+	bool bLODTierOverridden = false;
+
+	FDecisionMakerMetrics Metrics;
+
+	// Time spent scoring since the last ApplyDecision. Group members can score more than once per decision.
+	double PendingDecisionSeconds = 0;
+};
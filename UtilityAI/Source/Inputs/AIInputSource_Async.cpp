@@ -0,0 +1,114 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "AIInputSource_Async.h"
+#include "AIConsideration.h"
+#include "DecisionMakerComponent.h"
+#include "Engine/World.h"
+
+
+float UAIInputSource_Async::GetInput(const FDecisionMakerContext& Context) const
+{
+	// Results are delivered to a decision maker, and queries can only be started from the game thread
+	if (!Context.DecisionMaker || !IsInGameThread())
+		return DefaultInput;
+
+	const FAIAsyncInputKey Key{ FObjectKey(Context.DecisionMaker), FObjectKey(Context.Target) };
+
+	FAIAsyncInputState* State = States.Find(Key);
+	if (!State)
+	{
+		if (States.Num() >= 2 * FMath::Max(NumStatesAfterPrune, 16))
+		{
+			PruneStates();
+		}
+
+		State = &States.Add(Key);
+		State->DecisionMaker = Context.DecisionMaker;
+		State->Target = Context.Target;
+		State->bHasTarget = Context.Target != nullptr;
+	}
+
+	const bool bHasResult = State->ResultTime >= 0;
+	if (State->PendingQueryId == 0 && (!bHasResult || Context.CurrentTime - State->ResultTime >= ResultTimeToLive))
+	{
+		// Never hand out 0, it means "no query"
+		const uint32 QueryId = ++NextQueryId != 0 ? NextQueryId : ++NextQueryId;
+		if (StartQuery(Context, QueryId))
+		{
+			State->PendingQueryId = QueryId;
+			PendingQueries.Add(QueryId, Key);
+		}
+	}
+
+	return bHasResult ? State->Value : DefaultInput;
+}
+
+void UAIInputSource_Async::FinishQuery(uint32 QueryId, float Value) const
+{
+	FAIAsyncInputState* State = FindPendingState(QueryId);
+	if (!State)
+		return;
+
+	UDecisionMakerComponent* DecisionMaker = State->DecisionMaker.Get();
+	UWorld* World = DecisionMaker ? DecisionMaker->GetWorld() : nullptr;
+	if (!World)
+		return;
+
+	const bool bChanged = State->ResultTime < 0 || State->Value != Value;
+	State->Value = Value;
+	State->ResultTime = World->GetTimeSeconds();
+
+	// Input sources are instanced into the consideration that reads them
+	const UAIConsideration* Consideration = GetTypedOuter<UAIConsideration>();
+	if (bChanged && Consideration)
+	{
+		DecisionMaker->OnAsyncInputReady(Consideration);
+	}
+}
+
+void UAIInputSource_Async::FailQuery(uint32 QueryId) const
+{
+	FAIAsyncInputState* State = FindPendingState(QueryId);
+	if (!State)
+		return;
+
+	const UDecisionMakerComponent* DecisionMaker = State->DecisionMaker.Get();
+	if (const UWorld* World = DecisionMaker ? DecisionMaker->GetWorld() : nullptr)
+	{
+		if (State->ResultTime < 0)
+		{
+			State->Value = DefaultInput;
+		}
+		State->ResultTime = World->GetTimeSeconds();
+	}
+}
+
+FAIAsyncInputState* UAIInputSource_Async::FindPendingState(uint32 QueryId) const
+{
+	FAIAsyncInputKey Key;
+	if (!PendingQueries.RemoveAndCopyValue(QueryId, Key))
+		return nullptr;
+
+	FAIAsyncInputState* State = States.Find(Key);
+	if (!State || State->PendingQueryId != QueryId)
+		return nullptr;
+
+	State->PendingQueryId = 0;
+	return State;
+}
+
+void UAIInputSource_Async::PruneStates() const
+{
+	for (auto It = States.CreateIterator(); It; ++It)
+	{
+		const FAIAsyncInputState& State = It.Value();
+		if (!State.DecisionMaker.IsValid() || (State.bHasTarget && !State.Target.IsValid()))
+		{
+			PendingQueries.Remove(State.PendingQueryId);
+			It.RemoveCurrent();
+		}
+	}
+
+	NumStatesAfterPrune = States.Num();
+}
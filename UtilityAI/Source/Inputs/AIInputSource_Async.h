@@ -0,0 +1,92 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AIInputSource.h"
+#include "UObject/ObjectKey.h"
+#include "AIInputSource_Async.generated.h"
+
+
+class UDecisionMakerComponent;
+
+/** Async inputs keep a value per agent, and per target for targeted options */
+struct FAIAsyncInputKey
+{
+	FObjectKey DecisionMaker;
+
+	FObjectKey Target;
+
+	bool operator==(const FAIAsyncInputKey& Other) const { return DecisionMaker == Other.DecisionMaker && Target == Other.Target; }
+
+	friend uint32 GetTypeHash(const FAIAsyncInputKey& Key) { return HashCombine(GetTypeHash(Key.DecisionMaker), GetTypeHash(Key.Target)); }
+};
+
+struct FAIAsyncInputState
+{
+	TWeakObjectPtr<UDecisionMakerComponent> DecisionMaker;
+
+	// Set for targeted options. The state is dropped once the target has gone.
+	TWeakObjectPtr<AActor> Target;
+
+	bool bHasTarget = false;
+
+	float Value = 0.f;
+
+	// World time of the last result. Negative until the first one arrives.
+	double ResultTime = -1.0;
+
+	// The query in flight, or 0
+	uint32 PendingQueryId = 0;
+};
+
+/**
+ * Input that's too expensive to read while scoring (a path, a batch of traces...). GetInput returns the last result straight away
+ * (or DefaultInput before there is one), and starts a new query when that result is older than ResultTimeToLive.
+ * When a result comes in, the decision maker re-scores only the options that read this input, and decides again if that changes the outcome.
+ * Subclasses start the query in StartQuery and hand the result to FinishQuery. Game thread only, and only for agents with a decision maker.
+ */
+UCLASS(Abstract)
+class UTILITYAI_API UAIInputSource_Async : public UAIInputSource
+{
+	GENERATED_BODY()
+public:
+
+	/** Read until the first result arrives */
+	UPROPERTY(EditAnywhere, Category = "Input")
+	float DefaultInput = 0.f;
+
+	/** Start a new query once the last result is this many seconds old */
+	UPROPERTY(EditAnywhere, Category = "Input", meta = (ClampMin = "0"))
+	float ResultTimeToLive = 1.f;
+
+	virtual float GetInput(const FDecisionMakerContext& Context) const override;
+
+protected:
+
+	// Start a query for the agent in Context, and call FinishQuery or FailQuery with QueryId when it's done (not from inside StartQuery).
+	// Return false if the query couldn't be started.
+	virtual bool StartQuery(const FDecisionMakerContext& Context, uint32 QueryId) const PURE_VIRTUAL(UAIInputSource_Async::StartQuery, return false;);
+
+	// Store a query's result, and tell its decision maker if the value changed
+	void FinishQuery(uint32 QueryId, float Value) const;
+
+	// Keep the last value, and try again after ResultTimeToLive
+	void FailQuery(uint32 QueryId) const;
+
+private:
+
+	FAIAsyncInputState* FindPendingState(uint32 QueryId) const;
+
+	// Forget agents and targets that have gone. Runs when the number of states has doubled since last time, so it's cheap overall.
+	void PruneStates() const;
+
+	mutable TMap<FAIAsyncInputKey, FAIAsyncInputState> States;
+
+	// Where to deliver each query in flight
+	mutable TMap<uint32, FAIAsyncInputKey> PendingQueries;
+
+	mutable uint32 NextQueryId = 0;
+
+	mutable int32 NumStatesAfterPrune = 0;
+};
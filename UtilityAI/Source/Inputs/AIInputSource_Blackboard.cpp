@@ -0,0 +1,79 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "AIInputSource_Blackboard.h"
+#include "AIController.h"
+#include "BehaviorTree/BlackboardComponent.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Float.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Int.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Bool.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Object.h"
+
+
+namespace AIInputSourceBlackboard
+{
+	static const UBlackboardComponent* GetBlackboard(const FDecisionMakerContext& Context)
+	{
+		return Context.AIController ? Context.AIController->GetBlackboardComponent() : nullptr;
+	}
+}
+
+
+UAIInputSource_BlackboardFloat::UAIInputSource_BlackboardFloat()
+{
+	// The blackboard doesn't change while options are being scored
+	bThreadSafe = true;
+}
+
+float UAIInputSource_BlackboardFloat::GetInput(const FDecisionMakerContext& Context) const
+{
+	const UBlackboardComponent* Blackboard = AIInputSourceBlackboard::GetBlackboard(Context);
+	if (!Blackboard)
+		return 0.f;
+
+	const FBlackboard::FKey KeyID = Blackboard->GetKeyID(BlackboardKey);
+	const TSubclassOf<UBlackboardKeyType> KeyType = Blackboard->GetKeyType(KeyID);
+
+	if (KeyType == UBlackboardKeyType_Int::StaticClass())
+		return Blackboard->GetValue<UBlackboardKeyType_Int>(KeyID);
+
+	if (KeyType == UBlackboardKeyType_Float::StaticClass())
+		return Blackboard->GetValue<UBlackboardKeyType_Float>(KeyID);
+
+	return 0.f;
+}
+
+FString UAIInputSource_BlackboardFloat::GetInputDescription() const
+{
+	return FString::Printf(TEXT("Blackboard %s"), *BlackboardKey.ToString());
+}
+
+
+UAIInputSource_BlackboardBool::UAIInputSource_BlackboardBool()
+{
+	// The blackboard doesn't change while options are being scored
+	bThreadSafe = true;
+}
+
+float UAIInputSource_BlackboardBool::GetInput(const FDecisionMakerContext& Context) const
+{
+	const UBlackboardComponent* Blackboard = AIInputSourceBlackboard::GetBlackboard(Context);
+	if (!Blackboard)
+		return 0.f;
+
+	const FBlackboard::FKey KeyID = Blackboard->GetKeyID(BlackboardKey);
+	const TSubclassOf<UBlackboardKeyType> KeyType = Blackboard->GetKeyType(KeyID);
+
+	if (KeyType == UBlackboardKeyType_Bool::StaticClass())
+		return Blackboard->GetValue<UBlackboardKeyType_Bool>(KeyID) ? 1.f : 0.f;
+
+	if (KeyType == UBlackboardKeyType_Object::StaticClass())
+		return Blackboard->GetValue<UBlackboardKeyType_Object>(KeyID) ? 1.f : 0.f;
+
+	return 0.f;
+}
+
+FString UAIInputSource_BlackboardBool::GetInputDescription() const
+{
+	return FString::Printf(TEXT("Blackboard %s is set"), *BlackboardKey.ToString());
+}
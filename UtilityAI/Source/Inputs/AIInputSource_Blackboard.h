@@ -0,0 +1,47 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AIInputSource.h"
+#include "AIInputSource_Blackboard.generated.h"
+
+
+/**
+ * A float or int blackboard entry. 0 if the entry isn't set.
+ */
+UCLASS(BlueprintType)
+class UTILITYAI_API UAIInputSource_BlackboardFloat : public UAIInputSource
+{
+	GENERATED_BODY()
+public:
+
+	UPROPERTY(EditAnywhere, Category = "Input")
+	FName BlackboardKey;
+
+	UAIInputSource_BlackboardFloat();
+
+	virtual float GetInput(const FDecisionMakerContext& Context) const override;
+
+	virtual FString GetInputDescription() const override;
+};
+
+
+/**
+ * 1 if a bool blackboard entry is set (or an object entry isn't empty), otherwise 0
+ */
+UCLASS(BlueprintType)
+class UTILITYAI_API UAIInputSource_BlackboardBool : public UAIInputSource
+{
+	GENERATED_BODY()
+public:
+
+	UPROPERTY(EditAnywhere, Category = "Input")
+	FName BlackboardKey;
+
+	UAIInputSource_BlackboardBool();
+
+	virtual float GetInput(const FDecisionMakerContext& Context) const override;
+
+	virtual FString GetInputDescription() const override;
+};
@@ -0,0 +1,28 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "AIInputSource_Cooldown.h"
+#include "DecisionHistory.h"
+
+
+UAIInputSource_Cooldown::UAIInputSource_Cooldown()
+{
+	// Only reads decision history, which doesn't change while options are being scored
+	bThreadSafe = true;
+}
+
+float UAIInputSource_Cooldown::GetInput(const FDecisionMakerContext& Context) const
+{
+	const FName QueryOptionName = OptionName.IsNone() ? AIDecisionHistoryQuery::GetCurrentOptionName(Context) : OptionName;
+
+	const float TimeSinceEnded = AIDecisionHistoryQuery::GetTimeSince(Context, QueryOptionName, EDecisionHistoryQueryTime::Ended, QueryResultBitmask);
+	if (TimeSinceEnded < 0 || CooldownTime <= 0)
+		return 0.f;
+
+	return FMath::Clamp(1.f - TimeSinceEnded / CooldownTime, 0.f, 1.f);
+}
+
+FString UAIInputSource_Cooldown::GetInputDescription() const
+{
+	return FString::Printf(TEXT("Cooldown of %s (%.1fs)"), OptionName.IsNone() ? TEXT("current option") : *OptionName.ToString(), CooldownTime);
+}
@@ -0,0 +1,35 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AIInputSource.h"
+#include "AIInputSource_Cooldown.generated.h"
+
+
+/**
+ * How much of an option's cooldown is left, from 1 when it has just ended down to 0 once CooldownTime has passed.
+ * 0 if the option has never ended. Leave OptionName empty for the current option.
+ */
+UCLASS(BlueprintType)
+class UTILITYAI_API UAIInputSource_Cooldown : public UAIInputSource
+{
+	GENERATED_BODY()
+public:
+
+	UPROPERTY(EditAnywhere, Category = "Input")
+	FName OptionName;
+
+	UPROPERTY(EditAnywhere, Category = "Input", meta = (ClampMin = "0"))
+	float CooldownTime = 5.f;
+
+	/** Which endings start the cooldown */
+	UPROPERTY(EditAnywhere, Category = "Input", meta = (Bitmask, BitmaskEnum = "EDecisionHistoryQueryResult"))
+	int32 QueryResultBitmask = 0xF;
+
+	UAIInputSource_Cooldown();
+
+	virtual float GetInput(const FDecisionMakerContext& Context) const override;
+
+	virtual FString GetInputDescription() const override;
+};
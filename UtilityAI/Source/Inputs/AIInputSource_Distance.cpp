@@ -0,0 +1,75 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "AIInputSource_Distance.h"
+#include "AIController.h"
+#include "GameFramework/Pawn.h"
+#include "BehaviorTree/BlackboardComponent.h"
+
+
+bool AIDistanceInput::GetTargetLocation(const FDecisionMakerContext& Context, EAIDistanceInputTarget Target, FName BlackboardKey, const FVector& Location,
+	FVector& OutLocation, const AActor** OutActor)
+{
+	const AActor* TargetActor = nullptr;
+
+	switch (Target)
+	{
+	case EAIDistanceInputTarget::BlackboardKey:
+	{
+		const UBlackboardComponent* Blackboard = Context.AIController ? Context.AIController->GetBlackboardComponent() : nullptr;
+		if (!Blackboard || !Blackboard->GetLocationFromEntry(BlackboardKey, OutLocation))
+			return false;
+
+		TargetActor = Cast<AActor>(Blackboard->GetValueAsObject(BlackboardKey));
+		break;
+	}
+
+	case EAIDistanceInputTarget::OptionTarget:
+		if (!Context.Target)
+			return false;
+
+		TargetActor = Context.Target;
+		OutLocation = TargetActor->GetActorLocation();
+		break;
+
+	default:
+		OutLocation = Location;
+		break;
+	}
+
+	if (OutActor)
+	{
+		*OutActor = TargetActor;
+	}
+	return true;
+}
+
+
+UAIInputSource_Distance::UAIInputSource_Distance()
+{
+	// Only reads the blackboard and actor locations, which don't change while options are being scored
+	bThreadSafe = true;
+}
+
+float UAIInputSource_Distance::GetInput(const FDecisionMakerContext& Context) const
+{
+	FVector TargetLocation;
+	if (!Context.Pawn || !AIDistanceInput::GetTargetLocation(Context, Target, BlackboardKey, Location, TargetLocation))
+		return TNumericLimits<float>::Max();
+
+	const FVector PawnLocation = Context.Pawn->GetActorLocation();
+	return b2D ? FVector::Dist2D(PawnLocation, TargetLocation) : FVector::Dist(PawnLocation, TargetLocation);
+}
+
+FString UAIInputSource_Distance::GetInputDescription() const
+{
+	switch (Target)
+	{
+	case EAIDistanceInputTarget::BlackboardKey:
+		return FString::Printf(TEXT("Distance to %s"), *BlackboardKey.ToString());
+	case EAIDistanceInputTarget::OptionTarget:
+		return TEXT("Distance to target");
+	default:
+		return FString::Printf(TEXT("Distance to %s"), *Location.ToCompactString());
+	}
+}
@@ -0,0 +1,59 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AIInputSource.h"
+#include "AIInputSource_Distance.generated.h"
+
+
+UENUM(BlueprintType)
+enum class EAIDistanceInputTarget : uint8
+{
+	/** An actor or location in the blackboard */
+	BlackboardKey,
+
+	/** A fixed world location */
+	Location,
+
+	/** The target being scored, for options with a target generator */
+	OptionTarget
+};
+
+namespace AIDistanceInput
+{
+	// Find the location (and actor, if there is one) an input is measuring to. Returns false if the blackboard entry or target isn't set.
+	UTILITYAI_API bool GetTargetLocation(const FDecisionMakerContext& Context, EAIDistanceInputTarget Target, FName BlackboardKey, const FVector& Location,
+		FVector& OutLocation, const AActor** OutActor = nullptr);
+}
+
+/**
+ * Distance from the pawn to a blackboard entry, a fixed location, or the option's target.
+ * Very large if there's no pawn or the blackboard entry (or target) isn't set, so it reads as "out of range".
+ */
+UCLASS(BlueprintType)
+class UTILITYAI_API UAIInputSource_Distance : public UAIInputSource
+{
+	GENERATED_BODY()
+public:
+
+	UPROPERTY(EditAnywhere, Category = "Input")
+	EAIDistanceInputTarget Target = EAIDistanceInputTarget::BlackboardKey;
+
+	/** Object or vector key to measure to */
+	UPROPERTY(EditAnywhere, Category = "Input", meta = (EditCondition = "Target == EAIDistanceInputTarget::BlackboardKey"))
+	FName BlackboardKey;
+
+	UPROPERTY(EditAnywhere, Category = "Input", meta = (EditCondition = "Target == EAIDistanceInputTarget::Location"))
+	FVector Location = FVector::ZeroVector;
+
+	/** Ignore height differences */
+	UPROPERTY(EditAnywhere, Category = "Input")
+	bool b2D = false;
+
+	UAIInputSource_Distance();
+
+	virtual float GetInput(const FDecisionMakerContext& Context) const override;
+
+	virtual FString GetInputDescription() const override;
+};
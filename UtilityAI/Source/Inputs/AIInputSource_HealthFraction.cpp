@@ -0,0 +1,70 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "AIInputSource_HealthFraction.h"
+#include "GameFramework/Pawn.h"
+#include "Misc/ScopeRWLock.h"
+
+
+UAIInputSource_HealthFraction::UAIInputSource_HealthFraction()
+{
+	// Only reads properties, which don't change while options are being scored
+	bThreadSafe = true;
+}
+
+float UAIInputSource_HealthFraction::GetInput(const FDecisionMakerContext& Context) const
+{
+	const UObject* Object = ComponentClass && Context.Pawn ? static_cast<const UObject*>(Context.Pawn->FindComponentByClass(ComponentClass)) : Context.Pawn;
+	if (!Object)
+		return 0.f;
+
+	const FHealthProperties Properties = FindProperties(Object->GetClass());
+	if (!Properties.Health)
+		return 0.f;
+
+	const double Health = GetValue(Properties.Health, Object);
+	const double Max = Properties.MaxHealth ? GetValue(Properties.MaxHealth, Object) : MaxHealth;
+
+	return Max > 0 ? FMath::Clamp(float(Health / Max), 0.f, 1.f) : 0.f;
+}
+
+FString UAIInputSource_HealthFraction::GetInputDescription() const
+{
+	return FString::Printf(TEXT("%s fraction"), *HealthProperty.ToString());
+}
+
+#if WITH_EDITOR
+void UAIInputSource_HealthFraction::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+
+	// The property names might have changed
+	FWriteScopeLock WriteLock(PropertiesLock);
+	PropertiesByClass.Reset();
+}
+#endif
+
+UAIInputSource_HealthFraction::FHealthProperties UAIInputSource_HealthFraction::FindProperties(const UClass* Class) const
+{
+	{
+		FReadScopeLock ReadLock(PropertiesLock);
+		if (const FHealthProperties* Found = PropertiesByClass.Find(Class))
+			return *Found;
+	}
+
+	FHealthProperties Properties;
+	Properties.Health = CastField<FNumericProperty>(Class->FindPropertyByName(HealthProperty));
+	Properties.MaxHealth = MaxHealthProperty.IsNone() ? nullptr : CastField<FNumericProperty>(Class->FindPropertyByName(MaxHealthProperty));
+
+	FWriteScopeLock WriteLock(PropertiesLock);
+	PropertiesByClass.Add(Class, Properties);
+	return Properties;
+}
+
+double UAIInputSource_HealthFraction::GetValue(const FNumericProperty* Property, const UObject* Object)
+{
+	const void* Value = Property->ContainerPtrToValuePtr<void>(Object);
+	return Property->IsFloatingPoint()
+		? Property->GetFloatingPointPropertyValue(Value)
+		: double(Property->GetSignedIntPropertyValue(Value));
+}
@@ -0,0 +1,60 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AIInputSource.h"
+#include "AIInputSource_HealthFraction.generated.h"
+
+
+/**
+ * Health / MaxHealth, read from numeric properties on the pawn (or one of its components), so it works with any health setup.
+ * Properties are looked up once per class.
+ */
+UCLASS(BlueprintType)
+class UTILITYAI_API UAIInputSource_HealthFraction : public UAIInputSource
+{
+	GENERATED_BODY()
+public:
+
+	/** Read the properties from this component on the pawn, instead of the pawn itself */
+	UPROPERTY(EditAnywhere, Category = "Input")
+	TSubclassOf<UActorComponent> ComponentClass;
+
+	UPROPERTY(EditAnywhere, Category = "Input")
+	FName HealthProperty = TEXT("Health");
+
+	/** Leave empty to use MaxHealth instead */
+	UPROPERTY(EditAnywhere, Category = "Input")
+	FName MaxHealthProperty = TEXT("MaxHealth");
+
+	UPROPERTY(EditAnywhere, Category = "Input", meta = (ClampMin = "0"))
+	float MaxHealth = 100.f;
+
+	UAIInputSource_HealthFraction();
+
+	virtual float GetInput(const FDecisionMakerContext& Context) const override;
+
+	virtual FString GetInputDescription() const override;
+
+#if WITH_EDITOR
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
+
+protected:
+
+	struct FHealthProperties
+	{
+		const FNumericProperty* Health = nullptr;
+		const FNumericProperty* MaxHealth = nullptr;
+	};
+
+	FHealthProperties FindProperties(const UClass* Class) const;
+
+	static double GetValue(const FNumericProperty* Property, const UObject* Object);
+
+	// Scoring threads can look up properties at the same time
+	mutable FRWLock PropertiesLock;
+
+	mutable TMap<const UClass*, FHealthProperties> PropertiesByClass;
+};
@@ -0,0 +1,51 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "AIInputSource_LineOfSight.h"
+#include "GameFramework/Pawn.h"
+#include "Engine/World.h"
+#include "WorldCollision.h"
+
+
+bool UAIInputSource_LineOfSight::StartQuery(const FDecisionMakerContext& Context, uint32 QueryId) const
+{
+	UWorld* World = Context.Pawn ? Context.Pawn->GetWorld() : nullptr;
+	if (!World)
+		return false;
+
+	FVector TargetLocation;
+	const AActor* TargetActor = nullptr;
+	if (!AIDistanceInput::GetTargetLocation(Context, Target, BlackboardKey, Location, TargetLocation, &TargetActor))
+		return false;
+
+	FCollisionQueryParams Params(SCENE_QUERY_STAT(UtilityAILineOfSight), false, Context.Pawn);
+	if (TargetActor)
+	{
+		Params.AddIgnoredActor(TargetActor);
+	}
+
+	const FTraceDelegate Delegate = FTraceDelegate::CreateUObject(this, &UAIInputSource_LineOfSight::OnTraceDone, QueryId);
+	World->AsyncLineTraceByChannel(EAsyncTraceType::Test, Context.Pawn->GetPawnViewLocation(), TargetLocation + TargetOffset, TraceChannel, Params,
+		FCollisionResponseParams::DefaultResponseParam, &Delegate);
+
+	return true;
+}
+
+void UAIInputSource_LineOfSight::OnTraceDone(const FTraceHandle& Handle, FTraceDatum& Datum, uint32 QueryId) const
+{
+	// Test traces only report whether anything blocked them
+	FinishQuery(QueryId, Datum.OutHits.Num() > 0 ? 0.f : 1.f);
+}
+
+FString UAIInputSource_LineOfSight::GetInputDescription() const
+{
+	switch (Target)
+	{
+	case EAIDistanceInputTarget::BlackboardKey:
+		return FString::Printf(TEXT("Line of sight to %s"), *BlackboardKey.ToString());
+	case EAIDistanceInputTarget::OptionTarget:
+		return TEXT("Line of sight to target");
+	default:
+		return FString::Printf(TEXT("Line of sight to %s"), *Location.ToCompactString());
+	}
+}
@@ -0,0 +1,49 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AIInputSource_Async.h"
+#include "AIInputSource_Distance.h"
+#include "Engine/EngineTypes.h"
+#include "AIInputSource_LineOfSight.generated.h"
+
+
+struct FTraceHandle;
+struct FTraceDatum;
+
+/**
+ * 1 if nothing blocks a line from the pawn's eyes to a target, 0 if something does. Traced with the async trace API,
+ * so results arrive next frame.
+ */
+UCLASS(BlueprintType)
+class UTILITYAI_API UAIInputSource_LineOfSight : public UAIInputSource_Async
+{
+	GENERATED_BODY()
+public:
+
+	UPROPERTY(EditAnywhere, Category = "Input")
+	EAIDistanceInputTarget Target = EAIDistanceInputTarget::BlackboardKey;
+
+	/** Object or vector key to trace to */
+	UPROPERTY(EditAnywhere, Category = "Input", meta = (EditCondition = "Target == EAIDistanceInputTarget::BlackboardKey"))
+	FName BlackboardKey;
+
+	UPROPERTY(EditAnywhere, Category = "Input", meta = (EditCondition = "Target == EAIDistanceInputTarget::Location"))
+	FVector Location = FVector::ZeroVector;
+
+	/** Added to the target location, eg. to aim at the target's head */
+	UPROPERTY(EditAnywhere, Category = "Input")
+	FVector TargetOffset = FVector::ZeroVector;
+
+	UPROPERTY(EditAnywhere, Category = "Input")
+	TEnumAsByte<ECollisionChannel> TraceChannel = ECC_Visibility;
+
+	virtual FString GetInputDescription() const override;
+
+protected:
+
+	virtual bool StartQuery(const FDecisionMakerContext& Context, uint32 QueryId) const override;
+
+	void OnTraceDone(const FTraceHandle& Handle, FTraceDatum& Datum, uint32 QueryId) const;
+};
@@ -0,0 +1,67 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "AIInputSource_PathCost.h"
+#include "AIController.h"
+#include "GameFramework/Pawn.h"
+#include "NavigationSystem.h"
+#include "NavigationData.h"
+#include "NavFilters/NavigationQueryFilter.h"
+
+
+bool UAIInputSource_PathCost::StartQuery(const FDecisionMakerContext& Context, uint32 QueryId) const
+{
+	if (!Context.Pawn || !Context.AIController)
+		return false;
+
+	FVector TargetLocation;
+	if (!AIDistanceInput::GetTargetLocation(Context, Target, BlackboardKey, Location, TargetLocation))
+		return false;
+
+	UNavigationSystemV1* NavSys = FNavigationSystem::GetCurrent<UNavigationSystemV1>(Context.Pawn->GetWorld());
+	if (!NavSys)
+		return false;
+
+	const FVector PawnLocation = Context.Pawn->GetNavAgentLocation();
+	const FNavAgentProperties& AgentProperties = Context.AIController->GetNavAgentPropertiesRef();
+	const ANavigationData* NavData = NavSys->GetNavDataForProps(AgentProperties, PawnLocation);
+	if (!NavData)
+		return false;
+
+	FPathFindingQuery Query(Context.AIController, *NavData, PawnLocation, TargetLocation, UNavigationQueryFilter::GetQueryFilter(*NavData, Context.AIController, FilterClass));
+
+	const uint32 NavQueryId = NavSys->FindPathAsync(AgentProperties, Query,
+		FNavPathQueryDelegate::CreateUObject(this, &UAIInputSource_PathCost::OnPathFound, QueryId), EPathFindingMode::Regular);
+
+	return NavQueryId != INVALID_NAVQUERYID;
+}
+
+void UAIInputSource_PathCost::OnPathFound(uint32 NavQueryId, ENavigationQueryResult::Type Result, FNavPathSharedPtr Path, uint32 QueryId) const
+{
+	if (Result == ENavigationQueryResult::Success && Path.IsValid())
+	{
+		FinishQuery(QueryId, static_cast<float>(bUseCost ? Path->GetCost() : Path->GetLength()));
+	}
+	else if (Result == ENavigationQueryResult::Fail)
+	{
+		FinishQuery(QueryId, TNumericLimits<float>::Max());
+	}
+	else
+	{
+		// Bad query or navmesh not ready. Try again later.
+		FailQuery(QueryId);
+	}
+}
+
+FString UAIInputSource_PathCost::GetInputDescription() const
+{
+	switch (Target)
+	{
+	case EAIDistanceInputTarget::BlackboardKey:
+		return FString::Printf(TEXT("Path to %s"), *BlackboardKey.ToString());
+	case EAIDistanceInputTarget::OptionTarget:
+		return TEXT("Path to target");
+	default:
+		return FString::Printf(TEXT("Path to %s"), *Location.ToCompactString());
+	}
+}
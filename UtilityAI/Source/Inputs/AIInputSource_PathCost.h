@@ -0,0 +1,48 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AIInputSource_Async.h"
+#include "AIInputSource_Distance.h"
+#include "AI/Navigation/NavigationTypes.h"
+#include "AIInputSource_PathCost.generated.h"
+
+
+class UNavigationQueryFilter;
+
+/**
+ * Length (or cost) of the navmesh path from the pawn to a target, found with the navigation system's async pathfinding.
+ * Very large if there's no path, so it reads as "out of range".
+ */
+UCLASS(BlueprintType)
+class UTILITYAI_API UAIInputSource_PathCost : public UAIInputSource_Async
+{
+	GENERATED_BODY()
+public:
+
+	UPROPERTY(EditAnywhere, Category = "Input")
+	EAIDistanceInputTarget Target = EAIDistanceInputTarget::BlackboardKey;
+
+	/** Object or vector key to find a path to */
+	UPROPERTY(EditAnywhere, Category = "Input", meta = (EditCondition = "Target == EAIDistanceInputTarget::BlackboardKey"))
+	FName BlackboardKey;
+
+	UPROPERTY(EditAnywhere, Category = "Input", meta = (EditCondition = "Target == EAIDistanceInputTarget::Location"))
+	FVector Location = FVector::ZeroVector;
+
+	/** Use the path's cost (with area costs) instead of its length */
+	UPROPERTY(EditAnywhere, Category = "Input")
+	bool bUseCost = false;
+
+	UPROPERTY(EditAnywhere, Category = "Input")
+	TSubclassOf<UNavigationQueryFilter> FilterClass;
+
+	virtual FString GetInputDescription() const override;
+
+protected:
+
+	virtual bool StartQuery(const FDecisionMakerContext& Context, uint32 QueryId) const override;
+
+	void OnPathFound(uint32 NavQueryId, ENavigationQueryResult::Type Result, FNavPathSharedPtr Path, uint32 QueryId) const;
+};
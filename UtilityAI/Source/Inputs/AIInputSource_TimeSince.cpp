@@ -0,0 +1,26 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "AIInputSource_TimeSince.h"
+#include "DecisionHistory.h"
+
+
+UAIInputSource_TimeSince::UAIInputSource_TimeSince()
+{
+	// Only reads decision history, which doesn't change while options are being scored
+	bThreadSafe = true;
+}
+
+float UAIInputSource_TimeSince::GetInput(const FDecisionMakerContext& Context) const
+{
+	const FName QueryOptionName = OptionName.IsNone() ? AIDecisionHistoryQuery::GetCurrentOptionName(Context) : OptionName;
+
+	const float TimeElapsed = AIDecisionHistoryQuery::GetTimeSince(Context, QueryOptionName, QueryTime, QueryResultBitmask);
+	return TimeElapsed >= 0 ? TimeElapsed : TNumericLimits<float>::Max();
+}
+
+FString UAIInputSource_TimeSince::GetInputDescription() const
+{
+	return FString::Printf(TEXT("Time since %s %s"), OptionName.IsNone() ? TEXT("current option") : *OptionName.ToString(),
+		QueryTime == EDecisionHistoryQueryTime::Started ? TEXT("started") : TEXT("ended"));
+}
@@ -0,0 +1,34 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AIInputSource.h"
+#include "AIInputSource_TimeSince.generated.h"
+
+
+/**
+ * Seconds since an option started or ended, from the decision history. Leave OptionName empty for the current option.
+ * Very large if it never has.
+ */
+UCLASS(BlueprintType)
+class UTILITYAI_API UAIInputSource_TimeSince : public UAIInputSource
+{
+	GENERATED_BODY()
+public:
+
+	UPROPERTY(EditAnywhere, Category = "Input")
+	FName OptionName;
+
+	UPROPERTY(EditAnywhere, Category = "Input")
+	EDecisionHistoryQueryTime QueryTime = EDecisionHistoryQueryTime::Started;
+
+	UPROPERTY(EditAnywhere, Category = "Input", meta = (Bitmask, BitmaskEnum = "EDecisionHistoryQueryResult"))
+	int32 QueryResultBitmask = 0xF;
+
+	UAIInputSource_TimeSince();
+
+	virtual float GetInput(const FDecisionMakerContext& Context) const override;
+
+	virtual FString GetInputDescription() const override;
+};
@@ -0,0 +1,41 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "AITargetGenerator_PerceivedActors.h"
+#include "AIQueryLibrary.h"
+#include "GameFramework/Pawn.h"
+#include "Perception/AISense.h"
+
+
+UAITargetGenerator_PerceivedActors::UAITargetGenerator_PerceivedActors()
+{
+	// Perception doesn't change while options are being scored, and the query is shared through the frame cache
+	bThreadSafe = true;
+}
+
+void UAITargetGenerator_PerceivedActors::GenerateTargets(const FDecisionMakerContext& Context, TArray<AActor*>& OutTargets) const
+{
+	// Reused by every option on this thread
+	static thread_local TArray<AActor*> PerceivedActors;
+	UAIQueryLibrary::GetPerceivedActors(Context, Sense, PerceivedActors);
+
+	const int32 FirstTarget = OutTargets.Num();
+	for (AActor* Actor : PerceivedActors)
+	{
+		if (Actor && (!ActorClass || Actor->IsA(ActorClass)))
+		{
+			OutTargets.Add(Actor);
+		}
+	}
+
+	if (MaxTargets > 0 && OutTargets.Num() - FirstTarget > MaxTargets && Context.Pawn)
+	{
+		const FVector PawnLocation = Context.Pawn->GetActorLocation();
+		TArrayView<AActor*> Targets = MakeArrayView(OutTargets.GetData() + FirstTarget, OutTargets.Num() - FirstTarget);
+		Algo::Sort(Targets, [&PawnLocation](const AActor* A, const AActor* B)
+		{
+			return FVector::DistSquared(PawnLocation, A->GetActorLocation()) < FVector::DistSquared(PawnLocation, B->GetActorLocation());
+		});
+		OutTargets.SetNum(FirstTarget + MaxTargets, EAllowShrinking::No);
+	}
+}
@@ -0,0 +1,33 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AITargetGenerator.h"
+#include "AITargetGenerator_PerceivedActors.generated.h"
+
+
+class UAISense;
+
+/**
+ * Everything the AI controller currently perceives. Shared with other perception queries this frame.
+ * With MaxTargets set, the nearest targets are kept.
+ */
+UCLASS(BlueprintType)
+class UTILITYAI_API UAITargetGenerator_PerceivedActors : public UAITargetGenerator
+{
+	GENERATED_BODY()
+public:
+
+	/** Only actors perceived with this sense. Leave empty for any sense. */
+	UPROPERTY(EditAnywhere, Category = "Targets")
+	TSubclassOf<UAISense> Sense;
+
+	/** Only actors of this class */
+	UPROPERTY(EditAnywhere, Category = "Targets")
+	TSubclassOf<AActor> ActorClass;
+
+	UAITargetGenerator_PerceivedActors();
+
+	virtual void GenerateTargets(const FDecisionMakerContext& Context, TArray<AActor*>& OutTargets) const override;
+};
@@ -13,7 +13,10 @@ public
 		PCHUsage = ModuleRules.PCHUsageMode.UseExplicitOrSharedPCHs;
 
 		PublicIncludePaths.AddRange( new string[]{
-			Path.Combine(ModuleDirectory, "Considerations")
+			ModuleDirectory,
+			Path.Combine(ModuleDirectory, "Considerations"),
+			Path.Combine(ModuleDirectory, "Inputs"),
+			Path.Combine(ModuleDirectory, "Targets")
 			// ... add public include paths required here ...
 		} );
 
@@ -25,13 +28,13 @@ public
 
 
 		PublicDependencyModuleNames.AddRange( new string[]{
-			"Core"
+			"Core", "GameplayTags"
 			// ... add other public dependencies that you statically link with here ...
 		} );
 
 
 		PrivateDependencyModuleNames.AddRange( new string[]{
-			"CoreUObject", "Engine", "AIModule", "GameplayTasks", "Slate", "SlateCore"
+			"CoreUObject", "Engine", "AIModule", "GameplayTasks", "NavigationSystem", "Slate", "SlateCore"
 			// ... add private dependencies that you statically link with here ...
 		});
 
@@ -0,0 +1,426 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "UtilityAIBenchmarkCommandlet.h"
+#include "AIOptionSetDataAsset.h"
+#include "AIOption.h"
+#include "AIConsideration.h"
+#include "AIConsideration_ResponseCurve.h"
+#include "DecisionMakerComponent.h"
+#include "UtilityAIStats.h"
+#include "AIController.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+#include <atomic>
+
+
+DEFINE_LOG_CATEGORY_STATIC(LogUtilityAIBenchmark, Log, All);
+
+
+namespace UtilityAIBenchmark
+{
+	/**
+	 * Passes everything through to the real allocator. While counting, it counts allocations made by the game thread
+	 * and by workers scoring options (see FAIScoringThreadScope), and ignores whatever else the engine's threads are doing.
+	 * Installed once for the rest of the process and never destroyed, so threads that picked it up can always call into it.
+	 */
+	class FCountingMalloc final : public FMalloc
+	{
+	public:
+
+		// Install the counter the first time it's asked for
+		static FCountingMalloc& Get()
+		{
+			static FCountingMalloc* Instance = nullptr;
+			if (!Instance)
+			{
+				Instance = new FCountingMalloc(GMalloc);
+				GMalloc = Instance;
+			}
+			return *Instance;
+		}
+
+		void StartCounting()
+		{
+			NumAllocations.store(0, std::memory_order_relaxed);
+			NumBytes.store(0, std::memory_order_relaxed);
+			bCounting.store(true, std::memory_order_release);
+		}
+
+		void StopCounting()
+		{
+			bCounting.store(false, std::memory_order_release);
+		}
+
+		virtual void* Malloc(SIZE_T Count, uint32 Alignment) override
+		{
+			CountAllocation(Count);
+			return Inner->Malloc(Count, Alignment);
+		}
+
+		virtual void* Realloc(void* Original, SIZE_T Count, uint32 Alignment) override
+		{
+			if (Count > 0)
+			{
+				CountAllocation(Count);
+			}
+			return Inner->Realloc(Original, Count, Alignment);
+		}
+
+		virtual void Free(void* Original) override
+		{
+			Inner->Free(Original);
+		}
+
+		virtual SIZE_T QuantizeSize(SIZE_T Count, uint32 Alignment) override
+		{
+			return Inner->QuantizeSize(Count, Alignment);
+		}
+
+		virtual bool GetAllocationSize(void* Original, SIZE_T& SizeOut) override
+		{
+			return Inner->GetAllocationSize(Original, SizeOut);
+		}
+
+		virtual void Trim(bool bTrimThreadCaches) override
+		{
+			Inner->Trim(bTrimThreadCaches);
+		}
+
+		virtual void SetupTLSCachesOnCurrentThread() override
+		{
+			Inner->SetupTLSCachesOnCurrentThread();
+		}
+
+		virtual void ClearAndDisableTLSCachesOnCurrentThread() override
+		{
+			Inner->ClearAndDisableTLSCachesOnCurrentThread();
+		}
+
+		virtual bool IsInternallyThreadSafe() const override
+		{
+			return Inner->IsInternallyThreadSafe();
+		}
+
+		virtual const TCHAR* GetDescriptiveName() override
+		{
+			return TEXT("UtilityAIBenchmarkCountingMalloc");
+		}
+
+		uint64 GetNumAllocations() const
+		{
+			return NumAllocations.load(std::memory_order_relaxed);
+		}
+
+		uint64 GetNumBytes() const
+		{
+			return NumBytes.load(std::memory_order_relaxed);
+		}
+
+	private:
+
+		explicit FCountingMalloc(FMalloc* InInner)
+			: Inner(InInner)
+		{
+		}
+
+		void CountAllocation(SIZE_T Size)
+		{
+			if (bCounting.load(std::memory_order_acquire) && (IsInGameThread() || FAIScoringThreadScope::IsActive()))
+			{
+				NumAllocations.fetch_add(1, std::memory_order_relaxed);
+				NumBytes.fetch_add(Size, std::memory_order_relaxed);
+			}
+		}
+
+		FMalloc* Inner;
+
+		std::atomic<bool> bCounting{ false };
+
+		std::atomic<uint64> NumAllocations{ 0 };
+
+		// Bytes requested, including blocks that were freed again
+		std::atomic<uint64> NumBytes{ 0 };
+	};
+
+	/** Counts the game thread's and scoring workers' allocations for its lifetime */
+	class FScopedAllocationCounter
+	{
+	public:
+
+		FScopedAllocationCounter()
+		{
+			FCountingMalloc::Get().StartCounting();
+		}
+
+		~FScopedAllocationCounter()
+		{
+			FCountingMalloc::Get().StopCounting();
+		}
+
+		uint64 GetNumAllocations() const { return FCountingMalloc::Get().GetNumAllocations(); }
+
+		uint64 GetNumBytes() const { return FCountingMalloc::Get().GetNumBytes(); }
+	};
+
+	struct FResult
+	{
+		int32 NumAgents = 0;
+		int32 NumOptions = 0;
+		int32 NumConsiderations = 0;
+		float ScriptFraction = 0.f;
+		int64 NumDecisions = 0;
+		double Seconds = 0;
+		uint64 NumAllocations = 0;
+		uint64 NumAllocatedBytes = 0;
+
+		double GetDecisionsPerSecond() const { return Seconds > 0 ? NumDecisions / Seconds : 0.0; }
+		double GetNsPerDecision() const { return NumDecisions > 0 ? Seconds * 1.e9 / NumDecisions : 0.0; }
+		double GetNsPerOption() const { return NumOptions > 0 ? GetNsPerDecision() / NumOptions : 0.0; }
+		double GetNsPerConsideration() const { return NumConsiderations > 0 ? GetNsPerOption() / NumConsiderations : 0.0; }
+		double GetAllocationsPerDecision() const { return NumDecisions > 0 ? double(NumAllocations) / NumDecisions : 0.0; }
+		double GetBytesPerDecision() const { return NumDecisions > 0 ? double(NumAllocatedBytes) / NumDecisions : 0.0; }
+	};
+
+	template<typename ValueType>
+	TArray<ValueType> ParseList(const FString& Params, const TCHAR* Name, const TCHAR* Default)
+	{
+		FString ListString = Default;
+		FParse::Value(*Params, Name, ListString);
+
+		TArray<FString> Items;
+		ListString.ParseIntoArray(Items, TEXT(","));
+
+		TArray<ValueType> Values;
+		for (const FString& Item : Items)
+		{
+			ValueType Value;
+			LexFromString(Value, *Item);
+			Values.Add(Value);
+		}
+		return Values;
+	}
+}
+
+
+void UAIInputSource_Benchmark::Init(int32 InSalt, bool bInThreadSafe)
+{
+	Salt = InSalt;
+	bThreadSafe = bInThreadSafe;
+}
+
+float UAIInputSource_Benchmark::GetInput(const FDecisionMakerContext& Context) const
+{
+	const int32 AgentSeed = Context.DecisionMaker ? Context.DecisionMaker->RandomSeed : 0;
+	return FRandomStream(HashCombine(AgentSeed, Salt)).GetFraction();
+}
+
+
+UUtilityAIBenchmarkCommandlet::UUtilityAIBenchmarkCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = true;
+	LogToConsole = true;
+}
+
+int32 UUtilityAIBenchmarkCommandlet::Main(const FString& Params)
+{
+	using namespace UtilityAIBenchmark;
+
+	int32 NumAgents = 64;
+	int32 NumIterations = 100;
+	int32 NumWarmupIterations = 10;
+	int32 Seed = 1234;
+	FParse::Value(*Params, TEXT("Agents="), NumAgents);
+	FParse::Value(*Params, TEXT("Iterations="), NumIterations);
+	FParse::Value(*Params, TEXT("Warmup="), NumWarmupIterations);
+	FParse::Value(*Params, TEXT("Seed="), Seed);
+
+	const TArray<int32> OptionCounts = ParseList<int32>(Params, TEXT("Options="), TEXT("8,32,128"));
+	const TArray<int32> ConsiderationCounts = ParseList<int32>(Params, TEXT("Considerations="), TEXT("2,8"));
+	const TArray<float> ScriptFractions = ParseList<float>(Params, TEXT("ScriptFractions="), TEXT("0,1"));
+
+	FString BlueprintConsiderationPath;
+	if (FParse::Value(*Params, TEXT("BlueprintConsideration="), BlueprintConsiderationPath))
+	{
+		BlueprintConsiderationClass = LoadClass<UAIConsideration>(nullptr, *BlueprintConsiderationPath);
+		if (!BlueprintConsiderationClass)
+		{
+			UE_LOG(LogUtilityAIBenchmark, Error, TEXT("Couldn't load consideration class %s"), *BlueprintConsiderationPath);
+			return 1;
+		}
+	}
+
+	// Fail if any scenario allocates once it's warmed up, to catch allocations creeping back into the decision loop
+	const bool bRequireZeroAllocations = FParse::Param(*Params, TEXT("RequireZeroAllocations"));
+	bool bAllocated = false;
+
+	FString OutputPath = FPaths::ProjectSavedDir() / TEXT("UtilityAI") / TEXT("Benchmark.csv");
+	FParse::Value(*Params, TEXT("Output="), OutputPath);
+
+	// An empty game world to hold the agents. Nothing renders or ticks, we call the decision makers ourselves.
+	UWorld* World = UWorld::CreateWorld(EWorldType::Game, false, TEXT("UtilityAIBenchmark"));
+	World->AddToRoot();
+	FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+	WorldContext.SetCurrentWorld(World);
+	World->InitializeActorsForPlay(FURL());
+	World->BeginPlay();
+
+	TArray<UDecisionMakerComponent*> DecisionMakers;
+	for (int32 AgentIndex = 0; AgentIndex < NumAgents; ++AgentIndex)
+	{
+		AAIController* AIController = World->SpawnActor<AAIController>();
+		UDecisionMakerComponent* DecisionMaker = NewObject<UDecisionMakerComponent>(AIController);
+		DecisionMaker->RegisterComponent();
+		DecisionMaker->SetRandomSeed(Seed + AgentIndex);
+		DecisionMakers.Add(DecisionMaker);
+	}
+
+	TArray<FResult> Results;
+
+	for (const int32 NumOptions : OptionCounts)
+	{
+		for (const int32 NumConsiderations : ConsiderationCounts)
+		{
+			for (const float ScriptFraction : ScriptFractions)
+			{
+				// Same seed for every scenario, so a scenario generates the same option set no matter which others run
+				FRandomStream RandomStream(Seed);
+				UAIOptionSetDataAsset* OptionSet = CreateOptionSet(NumOptions, NumConsiderations, ScriptFraction, RandomStream);
+
+				for (int32 AgentIndex = 0; AgentIndex < DecisionMakers.Num(); ++AgentIndex)
+				{
+					DecisionMakers[AgentIndex]->BaseOptionSets = { OptionSet };
+					DecisionMakers[AgentIndex]->SetRandomSeed(Seed + AgentIndex);
+				}
+
+				// Compile the option set and grow the scratch buffers before we start timing
+				for (int32 Iteration = 0; Iteration < NumWarmupIterations; ++Iteration)
+				{
+					for (UDecisionMakerComponent* DecisionMaker : DecisionMakers)
+					{
+						DecisionMaker->RunDecisionMaker();
+					}
+				}
+
+				FResult& Result = Results.AddDefaulted_GetRef();
+				Result.NumAgents = DecisionMakers.Num();
+				Result.NumOptions = NumOptions;
+				Result.NumConsiderations = NumConsiderations;
+				Result.ScriptFraction = ScriptFraction;
+				Result.NumDecisions = int64(NumIterations) * DecisionMakers.Num();
+
+				{
+					FScopedAllocationCounter AllocationCounter;
+					const double StartSeconds = FPlatformTime::Seconds();
+
+					for (int32 Iteration = 0; Iteration < NumIterations; ++Iteration)
+					{
+						for (UDecisionMakerComponent* DecisionMaker : DecisionMakers)
+						{
+							DecisionMaker->RunDecisionMaker();
+						}
+					}
+
+					Result.Seconds = FPlatformTime::Seconds() - StartSeconds;
+					Result.NumAllocations = AllocationCounter.GetNumAllocations();
+					Result.NumAllocatedBytes = AllocationCounter.GetNumBytes();
+				}
+
+				UE_LOG(LogUtilityAIBenchmark, Display, TEXT("Options: %4d  Considerations: %3d  Script: %4.2f  |  %10.0f decisions/s  %10.1f ns/option  %8.1f ns/consideration  %6.2f allocs/decision  %8.1f bytes/decision"),
+					NumOptions, NumConsiderations, ScriptFraction,
+					Result.GetDecisionsPerSecond(), Result.GetNsPerOption(), Result.GetNsPerConsideration(), Result.GetAllocationsPerDecision(), Result.GetBytesPerDecision());
+
+				if (bRequireZeroAllocations && Result.NumAllocations > 0)
+				{
+					UE_LOG(LogUtilityAIBenchmark, Error, TEXT("Options: %4d  Considerations: %3d  Script: %4.2f  |  %llu allocations (%llu bytes) after warmup"),
+						NumOptions, NumConsiderations, ScriptFraction, Result.NumAllocations, Result.NumAllocatedBytes);
+					bAllocated = true;
+				}
+
+				for (UDecisionMakerComponent* DecisionMaker : DecisionMakers)
+				{
+					DecisionMaker->BaseOptionSets.Reset();
+				}
+				CollectGarbage(RF_NoFlags);
+			}
+		}
+	}
+
+	GEngine->DestroyWorldContext(World);
+	World->DestroyWorld(false);
+	World->RemoveFromRoot();
+
+	// ns per option and per consideration are spread over every option in the set, including ones that were pruned
+	FString Csv = TEXT("Agents,Options,Considerations,ScriptFraction,Seed,Decisions,Seconds,DecisionsPerSecond,NsPerDecision,NsPerOption,NsPerConsideration,AllocationsPerDecision,BytesPerDecision\n");
+	for (const FResult& Result : Results)
+	{
+		Csv += FString::Printf(TEXT("%d,%d,%d,%.2f,%d,%lld,%.6f,%.1f,%.1f,%.2f,%.2f,%.3f,%.1f\n"),
+			Result.NumAgents, Result.NumOptions, Result.NumConsiderations, Result.ScriptFraction, Seed, Result.NumDecisions, Result.Seconds,
+			Result.GetDecisionsPerSecond(), Result.GetNsPerDecision(), Result.GetNsPerOption(), Result.GetNsPerConsideration(), Result.GetAllocationsPerDecision(), Result.GetBytesPerDecision());
+	}
+
+	if (!FFileHelper::SaveStringToFile(Csv, *OutputPath))
+	{
+		UE_LOG(LogUtilityAIBenchmark, Error, TEXT("Couldn't write results to %s"), *OutputPath);
+		return 1;
+	}
+
+	UE_LOG(LogUtilityAIBenchmark, Display, TEXT("Wrote results to %s"), *OutputPath);
+	return bAllocated ? 1 : 0;
+}
+
+UAIOptionSetDataAsset* UUtilityAIBenchmarkCommandlet::CreateOptionSet(int32 NumOptions, int32 NumConsiderations, float ScriptFraction, FRandomStream& RandomStream) const
+{
+	UAIOptionSetDataAsset* OptionSet = NewObject<UAIOptionSetDataAsset>(GetTransientPackage());
+
+	// Spread script considerations evenly, so every scenario with the same fraction has the same number of them
+	const int32 NumTotalConsiderations = NumOptions * NumConsiderations;
+	const int32 NumScriptConsiderations = FMath::RoundToInt(NumTotalConsiderations * FMath::Clamp(ScriptFraction, 0.f, 1.f));
+	int32 ConsiderationIndex = 0;
+
+	for (int32 OptionIndex = 0; OptionIndex < NumOptions; ++OptionIndex)
+	{
+		UAIOption* Option = NewObject<UAIOption>(OptionSet);
+		Option->OptionName = *FString::Printf(TEXT("Option%d"), OptionIndex);
+		Option->BaseAddend = 1.f;
+
+		for (int32 Index = 0; Index < NumConsiderations; ++Index, ++ConsiderationIndex)
+		{
+			const bool bScript = NumScriptConsiderations > 0
+				&& (int64(ConsiderationIndex) * NumScriptConsiderations) / NumTotalConsiderations != (int64(ConsiderationIndex + 1) * NumScriptConsiderations) / NumTotalConsiderations;
+			Option->Considerations.Add(CreateConsideration(Option, bScript, RandomStream));
+		}
+
+		OptionSet->Options.Add(Option);
+	}
+
+	return OptionSet;
+}
+
+UAIConsideration* UUtilityAIBenchmarkCommandlet::CreateConsideration(UObject* Outer, bool bScript, FRandomStream& RandomStream) const
+{
+	if (bScript && BlueprintConsiderationClass)
+	{
+		return NewObject<UAIConsideration>(Outer, BlueprintConsiderationClass);
+	}
+
+	UAIConsideration_ResponseCurve* Consideration = NewObject<UAIConsideration_ResponseCurve>(Outer);
+
+	// Inputs that aren't thread-safe keep the consideration on the game thread and send it through the script VM
+	UAIInputSource_Benchmark* Input = NewObject<UAIInputSource_Benchmark>(Consideration);
+	Input->Init(RandomStream.RandHelper(MAX_int32), !bScript);
+	Consideration->Input = Input;
+
+	Consideration->Curve.Type = static_cast<EAIResponseCurveType>(RandomStream.RandRange(int32(EAIResponseCurveType::Linear), int32(EAIResponseCurveType::Logit)));
+	Consideration->Curve.Slope = RandomStream.FRandRange(0.5f, 4.f);
+	Consideration->Curve.XShift = RandomStream.FRandRange(0.f, 0.5f);
+	Consideration->Curve.YShift = RandomStream.FRandRange(0.f, 0.25f);
+	Consideration->OutputRange = FVector2D(RandomStream.FRandRange(0.f, 0.5f), 1.f);
+
+	return Consideration;
+}
@@ -0,0 +1,64 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "AIInputSource.h"
+#include "UtilityAIBenchmarkCommandlet.generated.h"
+
+
+class UAIConsideration;
+class UAIOptionSetDataAsset;
+class UDecisionMakerComponent;
+
+/**
+ * Input for benchmark considerations. Returns a fixed pseudo-random value per agent, so runs with the same seed score the same.
+ */
+UCLASS(Transient, HideDropdown)
+class UTILITYAIEDITOR_API UAIInputSource_Benchmark : public UAIInputSource
+{
+	GENERATED_BODY()
+public:
+
+	void Init(int32 InSalt, bool bInThreadSafe);
+
+	virtual float GetInput(const FDecisionMakerContext& Context) const override;
+
+protected:
+
+	int32 Salt = 0;
+};
+
+
+/**
+ * Headless decision throughput benchmark. Spawns synthetic agents in an empty game world, gives them generated option sets
+ * and times RunDecisionMaker for every combination of option count, consideration count and script fraction.
+ *
+ * UnrealEditor-Cmd.exe <Project> -run=UtilityAIBenchmark [-Agents=64] [-Options=8,32,128] [-Considerations=2,8]
+ *     [-ScriptFractions=0,1] [-Iterations=100] [-Warmup=10] [-Seed=1234] [-BlueprintConsideration=/Game/BP_Consideration.BP_Consideration_C]
+ *     [-Output=<csv path>] [-RequireZeroAllocations]
+ *
+ * Script considerations are called through the script VM like Blueprint ones are. Without -BlueprintConsideration they are
+ * response curve considerations with an input that isn't thread-safe, which measures the dispatch cost without any Blueprint logic.
+ */
+UCLASS()
+class UTILITYAIEDITOR_API UUtilityAIBenchmarkCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+public:
+
+	UUtilityAIBenchmarkCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+
+protected:
+
+	// Build an option set with NumOptions options of NumConsiderations considerations each
+	UAIOptionSetDataAsset* CreateOptionSet(int32 NumOptions, int32 NumConsiderations, float ScriptFraction, FRandomStream& RandomStream) const;
+
+	UAIConsideration* CreateConsideration(UObject* Outer, bool bScript, FRandomStream& RandomStream) const;
+
+	UPROPERTY(Transient)
+	UClass* BlueprintConsiderationClass;
+};
@@ -0,0 +1,24 @@
+// Alex Hajdu, (C) 2018, alexhajdu[at]me.com, twitter.com/alexhajdu
+
+using UnrealBuildTool;
+
+public
+class UtilityAIEditor : ModuleRules
+{
+public
+	UtilityAIEditor( ReadOnlyTargetRules Target )
+		: base( Target )
+	{
+		PCHUsage = ModuleRules.PCHUsageMode.UseExplicitOrSharedPCHs;
+
+		// Commandlets and other tools that don't belong in a shipped game
+		PublicDependencyModuleNames.AddRange( new string[]{
+			"Core", "CoreUObject", "Engine", "UtilityAI"
+		} );
+
+
+		PrivateDependencyModuleNames.AddRange( new string[]{
+			"AIModule", "GameplayTags"
+		});
+	}
+}
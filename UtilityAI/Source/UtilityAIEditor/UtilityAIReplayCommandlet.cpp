@@ -0,0 +1,90 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "UtilityAIReplayCommandlet.h"
+#include "AIDecisionRecording.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+
+DEFINE_LOG_CATEGORY_STATIC(LogUtilityAIReplay, Log, All);
+
+
+UUtilityAIReplayCommandlet::UUtilityAIReplayCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = true;
+	LogToConsole = true;
+}
+
+int32 UUtilityAIReplayCommandlet::Main(const FString& Params)
+{
+	FString RecordingPath;
+	if (!FParse::Value(*Params, TEXT("Recording="), RecordingPath))
+	{
+		UE_LOG(LogUtilityAIReplay, Error, TEXT("Usage: -run=UtilityAIReplay -Recording=<.uaidr file or directory> [-Repeat=10] [-Output=<csv path>]"));
+		return 1;
+	}
+
+	int32 NumRepeats = 10;
+	FParse::Value(*Params, TEXT("Repeat="), NumRepeats);
+	NumRepeats = FMath::Max(NumRepeats, 1);
+
+	FString OutputPath = FPaths::ProjectSavedDir() / TEXT("UtilityAI") / TEXT("Replay.csv");
+	FParse::Value(*Params, TEXT("Output="), OutputPath);
+
+	TArray<FString> Filenames;
+	if (IFileManager::Get().DirectoryExists(*RecordingPath))
+	{
+		IFileManager::Get().FindFiles(Filenames, *(RecordingPath / TEXT("*.uaidr")), true, false);
+		for (FString& Filename : Filenames)
+		{
+			Filename = RecordingPath / Filename;
+		}
+	}
+	else
+	{
+		Filenames.Add(RecordingPath);
+	}
+
+	FString Csv = TEXT("Recording,Agent,Decisions,Mismatches,Incomplete,Seconds,NsPerDecision\n");
+	int32 NumFailed = 0;
+
+	for (const FString& Filename : Filenames)
+	{
+		FAIDecisionReplayer Replayer;
+		if (!Replayer.LoadFromFile(Filename))
+		{
+			UE_LOG(LogUtilityAIReplay, Error, TEXT("Couldn't load recording %s"), *Filename);
+			++NumFailed;
+			continue;
+		}
+
+		const FAIDecisionReplayResult Result = Replayer.Replay(NumRepeats);
+		const double NsPerDecision = Result.NumDecisions > 0 ? Result.Seconds * 1.e9 / Result.NumDecisions : 0.0;
+
+		UE_LOG(LogUtilityAIReplay, Display, TEXT("%s (%s)  |  %d decisions  %d mismatches  %d incomplete  %10.1f ns/decision"),
+			*FPaths::GetCleanFilename(Filename), *Replayer.GetAgentName(), Result.NumDecisions, Result.NumMismatches, Result.NumIncomplete, NsPerDecision);
+
+		Csv += FString::Printf(TEXT("%s,%s,%d,%d,%d,%.6f,%.1f\n"),
+			*FPaths::GetCleanFilename(Filename), *Replayer.GetAgentName(), Result.NumDecisions, Result.NumMismatches, Result.NumIncomplete, Result.Seconds, NsPerDecision);
+
+		// Incomplete decisions weren't really replayed, so their timings and mismatches can't be trusted
+		if (Result.NumIncomplete > 0)
+		{
+			UE_LOG(LogUtilityAIReplay, Error, TEXT("%s has %d decisions that need scores it didn't record"), *FPaths::GetCleanFilename(Filename), Result.NumIncomplete);
+			++NumFailed;
+		}
+	}
+
+	if (!FFileHelper::SaveStringToFile(Csv, *OutputPath))
+	{
+		UE_LOG(LogUtilityAIReplay, Error, TEXT("Couldn't write results to %s"), *OutputPath);
+		return 1;
+	}
+
+	UE_LOG(LogUtilityAIReplay, Display, TEXT("Wrote results to %s"), *OutputPath);
+	return NumFailed > 0 ? 1 : 0;
+}
@@ -0,0 +1,25 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "UtilityAIReplayCommandlet.generated.h"
+
+
+/**
+ * Replays decision recordings (see UDecisionMakerComponent::StartRecording) without a world, and reports how fast they ran
+ * and how many decisions came out differently to the recording. Fails if any decision needed a score the recording doesn't have.
+ *
+ * UnrealEditor-Cmd.exe <Project> -run=UtilityAIReplay -Recording=<.uaidr file or directory> [-Repeat=10] [-Output=<csv path>]
+ */
+UCLASS()
+class UTILITYAIEDITOR_API UUtilityAIReplayCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+public:
+
+	UUtilityAIReplayCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,70 @@
+// Alex Hajdu, (C) 2018, alexhajdu[at]me.com, twitter.com/alexhajdu
+
+#include "UtilityAIModule.h"
+#include "AIOptionSetDataAsset.h"
+#include "AIOption.h"
+#include "UtilityAIStats.h"
+#include "UObject/UObjectIterator.h"
+
+#define LOCTEXT_NAMESPACE "FUtilityAIModule"
+
+void FUtilityAIModule::StartupModule( )
+{
+	// This code will execute after your module is loaded into memory; the exact timing is specified in the .uplugin file per-module
+
+#if ENGINE_MAJOR_VERSION == 5
+	ReloadCompleteHandle = FCoreUObjectDelegates::ReloadCompleteDelegate.AddLambda([this](EReloadCompleteReason)
+	{
+		InvalidateCompiledOptionSets();
+	});
+#endif
+
+#if WITH_EDITOR
+	// Blueprint recompiles replace consideration instances
+	ObjectsReplacedHandle = FCoreUObjectDelegates::OnObjectsReplaced.AddLambda([this](const TMap<UObject*, UObject*>&)
+	{
+		InvalidateCompiledOptionSets();
+	});
+#endif
+
+	// Not from the subsystem's tick, which only runs while there are decision makers (servers running only Mass entities have none)
+	LogStatsTickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateLambda([](float)
+	{
+		FAIDecisionMetrics::Get().LogIfDue();
+		return true;
+	}), 1.f);
+}
+
+void FUtilityAIModule::ShutdownModule( )
+{
+	// This function may be called during shutdown to clean up your module.  For modules that support dynamic reloading,
+	// we call this function before unloading the module.
+
+#if ENGINE_MAJOR_VERSION == 5
+	FCoreUObjectDelegates::ReloadCompleteDelegate.Remove(ReloadCompleteHandle);
+#endif
+
+#if WITH_EDITOR
+	FCoreUObjectDelegates::OnObjectsReplaced.Remove(ObjectsReplacedHandle);
+#endif
+
+	FTSTicker::GetCoreTicker().RemoveTicker(LogStatsTickerHandle);
+}
+
+void FUtilityAIModule::InvalidateCompiledOptionSets()
+{
+	for (TObjectIterator<UAIOptionSetDataAsset> It; It; ++It)
+	{
+		It->InvalidateCompiledOptionSet();
+	}
+
+	// Options outside any asset keep a compiled copy of their own
+	for (TObjectIterator<UAIOption> It; It; ++It)
+	{
+		It->InvalidateCompiledOption();
+	}
+}
+
+#undef LOCTEXT_NAMESPACE
+
+IMPLEMENT_MODULE( FUtilityAIModule, UtilityAI)
\ No newline at end of file
@@ -0,0 +1,32 @@
+// Copyright 1998-2018 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Ticker.h"
+
+#if ENGINE_MAJOR_VERSION == 5 || ENGINE_MAJOR_VERSION == 4 && ENGINE_MINOR_VERSION >= 25
+#include "Modules/ModuleManager.h"
+#else
+#include "ModuleManager.h"
+#endif
+
+class FUtilityAIModule : public IModuleInterface
+{
+public:
+
+	/** IModuleInterface implementation */
+	virtual void StartupModule() override;
+	virtual void ShutdownModule() override;
+
+private:
+
+	// Compiled option sets hold raw pointers to options and considerations, so rebuild them whenever those might have been replaced
+	void InvalidateCompiledOptionSets();
+
+	FDelegateHandle ReloadCompleteHandle;
+	FDelegateHandle ObjectsReplacedHandle;
+
+	// Logs decision metrics every UtilityAI.LogStatsInterval, whether agents are components or Mass entities
+	FTSTicker::FDelegateHandle LogStatsTickerHandle;
+};
\ No newline at end of file
@@ -0,0 +1,401 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "UtilityAIStats.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/OutputDevice.h"
+#include "Misc/OutputDeviceRedirector.h"
+
+
+DEFINE_STAT(STAT_UtilityAI_RunDecisionMaker);
+DEFINE_STAT(STAT_UtilityAI_GatherOptionSets);
+DEFINE_STAT(STAT_UtilityAI_ScoreOptions);
+DEFINE_STAT(STAT_UtilityAI_ScoreOption);
+DEFINE_STAT(STAT_UtilityAI_SelectOption);
+DEFINE_STAT(STAT_UtilityAI_SetCurrentOption);
+DEFINE_STAT(STAT_UtilityAI_MassDecisions);
+DEFINE_STAT(STAT_UtilityAI_GroupDecisions);
+
+DEFINE_STAT(STAT_UtilityAI_Decisions);
+DEFINE_STAT(STAT_UtilityAI_OptionsScored);
+DEFINE_STAT(STAT_UtilityAI_OptionEarlyOuts);
+DEFINE_STAT(STAT_UtilityAI_OptionsOnCooldown);
+DEFINE_STAT(STAT_UtilityAI_ConsiderationsScored);
+DEFINE_STAT(STAT_UtilityAI_ConsiderationsFromCache);
+DEFINE_STAT(STAT_UtilityAI_ConsiderationsSharedInGroup);
+DEFINE_STAT(STAT_UtilityAI_OptionsClaimedInGroup);
+DEFINE_STAT(STAT_UtilityAI_GroupRescores);
+DEFINE_STAT(STAT_UtilityAI_AsyncRescores);
+DEFINE_STAT(STAT_UtilityAI_TreeRestarts);
+
+UE_TRACE_CHANNEL_DEFINE(UtilityAIChannel);
+
+CSV_DEFINE_CATEGORY_MODULE(UTILITYAI_API, UtilityAI, true);
+
+
+TAutoConsoleVariable<int32> CVarUtilityAICollectTimings(
+	TEXT("UtilityAI.CollectTimings"),
+	0,
+	TEXT("Time every consideration and keep a histogram per consideration class.\n")
+	TEXT("  0: off\n")
+	TEXT("  1: on\n")
+);
+
+static FAutoConsoleCommandWithOutputDevice DumpConsiderationTimingsCommand(
+	TEXT("UtilityAI.DumpConsiderationTimings"),
+	TEXT("Print how long each consideration class has taken to score since timings were last reset"),
+	FConsoleCommandWithOutputDeviceDelegate::CreateLambda([](FOutputDevice& Ar)
+	{
+		FAIConsiderationTimings::Get().Dump(Ar);
+	}));
+
+static FAutoConsoleCommand ResetConsiderationTimingsCommand(
+	TEXT("UtilityAI.ResetConsiderationTimings"),
+	TEXT("Forget all collected consideration timings"),
+	FConsoleCommandDelegate::CreateLambda([]()
+	{
+		FAIConsiderationTimings::Get().Reset();
+	}));
+
+TAutoConsoleVariable<int32> CVarUtilityAICollectMetrics(
+	TEXT("UtilityAI.CollectMetrics"),
+	1,
+	TEXT("Count decisions, option switches and tree restarts, and time every decision, for UtilityAI.Stats and UtilityAI.Top.\n")
+	TEXT("  0: off\n")
+	TEXT("  1: on\n")
+);
+
+TAutoConsoleVariable<float> CVarUtilityAILogStatsInterval(
+	TEXT("UtilityAI.LogStatsInterval"),
+	0.f,
+	TEXT("Log decision metrics for the last interval every this many seconds. Useful on dedicated servers.\n")
+	TEXT("  0: off\n")
+);
+
+static FAutoConsoleCommandWithOutputDevice StatsCommand(
+	TEXT("UtilityAI.Stats"),
+	TEXT("Print decisions per second, decision times, option switches and tree restarts since metrics were last reset"),
+	FConsoleCommandWithOutputDeviceDelegate::CreateLambda([](FOutputDevice& Ar)
+	{
+		FAIDecisionMetrics::Get().Dump(Ar);
+	}));
+
+static FAutoConsoleCommand ResetStatsCommand(
+	TEXT("UtilityAI.ResetStats"),
+	TEXT("Forget all collected decision metrics"),
+	FConsoleCommandDelegate::CreateLambda([]()
+	{
+		FAIDecisionMetrics::Get().Reset();
+	}));
+
+
+namespace UtilityAIStats
+{
+	static thread_local int32 ScoringThreadScopeDepth = 0;
+}
+
+FAIScoringThreadScope::FAIScoringThreadScope()
+{
+	++UtilityAIStats::ScoringThreadScopeDepth;
+}
+
+FAIScoringThreadScope::~FAIScoringThreadScope()
+{
+	--UtilityAIStats::ScoringThreadScopeDepth;
+}
+
+bool FAIScoringThreadScope::IsActive()
+{
+	return UtilityAIStats::ScoringThreadScopeDepth > 0;
+}
+
+
+FAIConsiderationTimings& FAIConsiderationTimings::Get()
+{
+	static FAIConsiderationTimings Instance;
+	return Instance;
+}
+
+bool FAIConsiderationTimings::IsEnabled()
+{
+	return CVarUtilityAICollectTimings.GetValueOnAnyThread() != 0;
+}
+
+void FAIConsiderationTimings::Add(const UClass* ConsiderationClass, double Seconds, int32 NumScores)
+{
+	if (!ConsiderationClass || NumScores <= 0)
+		return;
+
+	const double SecondsPerScore = Seconds / NumScores;
+
+	int32 Bucket = 0;
+	for (double BucketLimit = 1.e-6; Bucket < NumBuckets - 1 && SecondsPerScore >= BucketLimit; BucketLimit *= 4.0)
+	{
+		++Bucket;
+	}
+
+	FScopeLock ScopeLock(&Lock);
+
+	FClassTimings* ClassTimings = Timings.Find(ConsiderationClass);
+	if (!ClassTimings)
+	{
+		ClassTimings = &Timings.Add(ConsiderationClass);
+		ClassTimings->ClassName = ConsiderationClass->GetName();
+		ClassTimings->bNative = ConsiderationClass->HasAnyClassFlags(CLASS_Native);
+	}
+
+	ClassTimings->Count += NumScores;
+	ClassTimings->TotalSeconds += Seconds;
+	ClassTimings->MaxSeconds = FMath::Max(ClassTimings->MaxSeconds, SecondsPerScore);
+	ClassTimings->Buckets[Bucket] += NumScores;
+}
+
+void FAIConsiderationTimings::Reset()
+{
+	FScopeLock ScopeLock(&Lock);
+	Timings.Reset();
+}
+
+void FAIConsiderationTimings::GetTimings(TArray<FClassTimings>& OutTimings) const
+{
+	{
+		FScopeLock ScopeLock(&Lock);
+		Timings.GenerateValueArray(OutTimings);
+	}
+
+	OutTimings.Sort([](const FClassTimings& A, const FClassTimings& B)
+	{
+		return A.TotalSeconds > B.TotalSeconds;
+	});
+}
+
+void FAIConsiderationTimings::Dump(FOutputDevice& Ar) const
+{
+	TArray<FClassTimings> SortedTimings;
+	GetTimings(SortedTimings);
+
+	if (SortedTimings.Num() == 0)
+	{
+		Ar.Logf(TEXT("No consideration timings. Set UtilityAI.CollectTimings 1 to collect them."));
+		return;
+	}
+
+	Ar.Logf(TEXT("%-48s %6s %10s %10s %10s %10s   Histogram (<1us <4us <16us <64us <256us <1ms <4ms >=4ms)"),
+		TEXT("Consideration"), TEXT("Type"), TEXT("Count"), TEXT("Total ms"), TEXT("Avg us"), TEXT("Max us"));
+
+	for (const FClassTimings& ClassTimings : SortedTimings)
+	{
+		FString Histogram;
+		for (int32 Bucket = 0; Bucket < NumBuckets; ++Bucket)
+		{
+			Histogram += FString::Printf(TEXT(" %llu"), ClassTimings.Buckets[Bucket]);
+		}
+
+		Ar.Logf(TEXT("%-48s %6s %10llu %10.3f %10.3f %10.3f  %s"),
+			*ClassTimings.ClassName,
+			ClassTimings.bNative ? TEXT("C++") : TEXT("BP"),
+			ClassTimings.Count,
+			ClassTimings.TotalSeconds * 1000.0,
+			ClassTimings.Count > 0 ? ClassTimings.TotalSeconds * 1.e6 / ClassTimings.Count : 0.0,
+			ClassTimings.MaxSeconds * 1.e6,
+			*Histogram);
+	}
+}
+
+
+FAIDecisionMetrics& FAIDecisionMetrics::Get()
+{
+	static FAIDecisionMetrics Instance;
+	return Instance;
+}
+
+bool FAIDecisionMetrics::IsEnabled()
+{
+	return CVarUtilityAICollectMetrics.GetValueOnAnyThread() != 0;
+}
+
+FAIDecisionMetrics::FAIDecisionMetrics()
+{
+	StartSeconds = FPlatformTime::Seconds();
+}
+
+void FAIDecisionMetrics::AddDecision(FName OptionSetsName, double Seconds, bool bSwitchedOption)
+{
+	CSV_CUSTOM_STAT(UtilityAI, Decisions, 1, ECsvCustomStatOp::Accumulate);
+	CSV_CUSTOM_STAT(UtilityAI, DecisionMs, float(Seconds * 1000.0), ECsvCustomStatOp::Accumulate);
+	CSV_CUSTOM_STAT(UtilityAI, OptionSwitches, bSwitchedOption ? 1 : 0, ECsvCustomStatOp::Accumulate);
+
+	FScopeLock ScopeLock(&Lock);
+	AddLocked(OptionSetsName, 1, Seconds, Seconds, bSwitchedOption ? 1 : 0);
+}
+
+void FAIDecisionMetrics::AddDecisions(FName OptionSetsName, int32 NumDecisions, double Seconds, int32 NumSwitchedOptions)
+{
+	if (NumDecisions <= 0)
+		return;
+
+	CSV_CUSTOM_STAT(UtilityAI, Decisions, NumDecisions, ECsvCustomStatOp::Accumulate);
+	CSV_CUSTOM_STAT(UtilityAI, DecisionMs, float(Seconds * 1000.0), ECsvCustomStatOp::Accumulate);
+	CSV_CUSTOM_STAT(UtilityAI, OptionSwitches, NumSwitchedOptions, ECsvCustomStatOp::Accumulate);
+
+	FScopeLock ScopeLock(&Lock);
+	AddLocked(OptionSetsName, NumDecisions, Seconds, Seconds / NumDecisions, NumSwitchedOptions);
+}
+
+void FAIDecisionMetrics::AddLocked(FName OptionSetsName, int32 NumDecisions, double Seconds, double SecondsEach, int32 NumSwitchedOptions)
+{
+	int32 Bucket = 0;
+	for (double BucketLimit = 1.e-6; Bucket < NumBuckets - 1 && SecondsEach >= BucketLimit; BucketLimit *= 2.0)
+	{
+		++Bucket;
+	}
+
+	Totals.Decisions += NumDecisions;
+	Totals.OptionSwitches += NumSwitchedOptions;
+	Totals.DecisionSeconds += Seconds;
+	Totals.MaxDecisionSeconds = FMath::Max(Totals.MaxDecisionSeconds, SecondsEach);
+	Totals.Buckets[Bucket] += NumDecisions;
+
+	FOptionSetMetrics& OptionSet = OptionSets.FindOrAdd(OptionSetsName);
+	OptionSet.Name = OptionSetsName;
+	OptionSet.Decisions += NumDecisions;
+	OptionSet.TotalSeconds += Seconds;
+	OptionSet.MaxSeconds = FMath::Max(OptionSet.MaxSeconds, SecondsEach);
+}
+
+void FAIDecisionMetrics::AddTreeRestart()
+{
+	CSV_CUSTOM_STAT(UtilityAI, TreeRestarts, 1, ECsvCustomStatOp::Accumulate);
+
+	FScopeLock ScopeLock(&Lock);
+	++Totals.TreeRestarts;
+}
+
+void FAIDecisionMetrics::Reset()
+{
+	FScopeLock ScopeLock(&Lock);
+	StartSeconds = FPlatformTime::Seconds();
+	Totals = FTotals();
+	LoggedTotals = FTotals();
+	OptionSets.Reset();
+}
+
+FAIDecisionMetrics::FTotals FAIDecisionMetrics::GetTotals() const
+{
+	FScopeLock ScopeLock(&Lock);
+	FTotals Result = Totals;
+	Result.Seconds = FPlatformTime::Seconds() - StartSeconds;
+	return Result;
+}
+
+void FAIDecisionMetrics::GetOptionSets(TArray<FOptionSetMetrics>& OutOptionSets) const
+{
+	{
+		FScopeLock ScopeLock(&Lock);
+		OptionSets.GenerateValueArray(OutOptionSets);
+	}
+
+	OutOptionSets.Sort([](const FOptionSetMetrics& A, const FOptionSetMetrics& B)
+	{
+		return A.TotalSeconds > B.TotalSeconds;
+	});
+}
+
+double FAIDecisionMetrics::FTotals::GetPercentileSeconds(double Percentile) const
+{
+	const uint64 Target = uint64(FMath::CeilToDouble(Decisions * FMath::Clamp(Percentile, 0.0, 1.0)));
+
+	uint64 Count = 0;
+	double BucketLimit = 1.e-6;
+	for (int32 Bucket = 0; Bucket < NumBuckets - 1; ++Bucket, BucketLimit *= 2.0)
+	{
+		Count += Buckets[Bucket];
+		if (Count >= Target)
+			return BucketLimit;
+	}
+
+	// Slower than the last bucket's limit, so the max is the best we know
+	return MaxDecisionSeconds;
+}
+
+FAIDecisionMetrics::FTotals FAIDecisionMetrics::FTotals::GetDelta(const FTotals& Earlier) const
+{
+	FTotals Delta = *this;
+	Delta.Seconds -= Earlier.Seconds;
+	Delta.Decisions -= Earlier.Decisions;
+	Delta.OptionSwitches -= Earlier.OptionSwitches;
+	Delta.TreeRestarts -= Earlier.TreeRestarts;
+	Delta.DecisionSeconds -= Earlier.DecisionSeconds;
+	for (int32 Bucket = 0; Bucket < NumBuckets; ++Bucket)
+	{
+		Delta.Buckets[Bucket] -= Earlier.Buckets[Bucket];
+	}
+	return Delta;
+}
+
+void FAIDecisionMetrics::Dump(FOutputDevice& Ar) const
+{
+	if (!IsEnabled())
+	{
+		Ar.Logf(TEXT("Decision metrics are off. Set UtilityAI.CollectMetrics 1 to collect them."));
+	}
+
+	DumpTotals(GetTotals(), Ar);
+}
+
+void FAIDecisionMetrics::DumpTotals(const FTotals& Summary, FOutputDevice& Ar)
+{
+	const double Seconds = FMath::Max(Summary.Seconds, 0.001);
+
+	Ar.Logf(TEXT("UtilityAI over %.1f s: %llu decisions (%.1f/s), %llu option switches (%.1f/s), %llu tree restarts (%.1f/s)"),
+		Summary.Seconds,
+		Summary.Decisions, Summary.Decisions / Seconds,
+		Summary.OptionSwitches, Summary.OptionSwitches / Seconds,
+		Summary.TreeRestarts, Summary.TreeRestarts / Seconds);
+
+	if (Summary.Decisions == 0)
+		return;
+
+	Ar.Logf(TEXT("  Decision time: avg %.1f us, p50 <%.0f us, p90 <%.0f us, p99 <%.0f us, max %.1f us, total %.2f ms/s"),
+		Summary.DecisionSeconds * 1.e6 / Summary.Decisions,
+		Summary.GetPercentileSeconds(0.5) * 1.e6,
+		Summary.GetPercentileSeconds(0.9) * 1.e6,
+		Summary.GetPercentileSeconds(0.99) * 1.e6,
+		Summary.MaxDecisionSeconds * 1.e6,
+		Summary.DecisionSeconds * 1000.0 / Seconds);
+
+	Ar.Logf(TEXT("  Switch rate: %.1f%% of decisions picked a different option"), 100.0 * Summary.OptionSwitches / Summary.Decisions);
+}
+
+void FAIDecisionMetrics::DumpTopOptionSets(int32 MaxOptionSets, FOutputDevice& Ar) const
+{
+	TArray<FOptionSetMetrics> SortedOptionSets;
+	GetOptionSets(SortedOptionSets);
+
+	Ar.Logf(TEXT("%-64s %10s %10s %10s %10s"), TEXT("Option sets"), TEXT("Decisions"), TEXT("Total ms"), TEXT("Avg us"), TEXT("Max us"));
+
+	for (int32 Index = 0; Index < SortedOptionSets.Num() && Index < MaxOptionSets; ++Index)
+	{
+		const FOptionSetMetrics& OptionSet = SortedOptionSets[Index];
+		Ar.Logf(TEXT("%-64s %10llu %10.3f %10.3f %10.3f"),
+			*OptionSet.Name.ToString(),
+			OptionSet.Decisions,
+			OptionSet.TotalSeconds * 1000.0,
+			OptionSet.Decisions > 0 ? OptionSet.TotalSeconds * 1.e6 / OptionSet.Decisions : 0.0,
+			OptionSet.MaxSeconds * 1.e6);
+	}
+}
+
+void FAIDecisionMetrics::LogIfDue()
+{
+	const float Interval = CVarUtilityAILogStatsInterval.GetValueOnGameThread();
+	if (Interval <= 0)
+		return;
+
+	const FTotals CurrentTotals = GetTotals();
+	if (CurrentTotals.Seconds - LoggedTotals.Seconds < Interval)
+		return;
+
+	DumpTotals(CurrentTotals.GetDelta(LoggedTotals), *GLog);
+	LoggedTotals = CurrentTotals;
+}
@@ -0,0 +1,226 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+#include "Trace/Trace.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+#include "UObject/ObjectKey.h"
+
+
+// --- Stats (stat UtilityAI) ---
+
+DECLARE_STATS_GROUP(TEXT("UtilityAI"), STATGROUP_UtilityAI, STATCAT_Advanced);
+
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Run Decision Maker"), STAT_UtilityAI_RunDecisionMaker, STATGROUP_UtilityAI, UTILITYAI_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Gather Option Sets"), STAT_UtilityAI_GatherOptionSets, STATGROUP_UtilityAI, UTILITYAI_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Score Options"), STAT_UtilityAI_ScoreOptions, STATGROUP_UtilityAI, UTILITYAI_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Score Option"), STAT_UtilityAI_ScoreOption, STATGROUP_UtilityAI, UTILITYAI_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Select Option"), STAT_UtilityAI_SelectOption, STATGROUP_UtilityAI, UTILITYAI_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Set Current Option"), STAT_UtilityAI_SetCurrentOption, STATGROUP_UtilityAI, UTILITYAI_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Mass Decisions"), STAT_UtilityAI_MassDecisions, STATGROUP_UtilityAI, UTILITYAI_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Group Decisions"), STAT_UtilityAI_GroupDecisions, STATGROUP_UtilityAI, UTILITYAI_API);
+
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Decisions"), STAT_UtilityAI_Decisions, STATGROUP_UtilityAI, UTILITYAI_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Options Scored"), STAT_UtilityAI_OptionsScored, STATGROUP_UtilityAI, UTILITYAI_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Option Early Outs"), STAT_UtilityAI_OptionEarlyOuts, STATGROUP_UtilityAI, UTILITYAI_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Options On Cooldown"), STAT_UtilityAI_OptionsOnCooldown, STATGROUP_UtilityAI, UTILITYAI_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Considerations Scored"), STAT_UtilityAI_ConsiderationsScored, STATGROUP_UtilityAI, UTILITYAI_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Considerations From Cache"), STAT_UtilityAI_ConsiderationsFromCache, STATGROUP_UtilityAI, UTILITYAI_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Considerations Shared In Group"), STAT_UtilityAI_ConsiderationsSharedInGroup, STATGROUP_UtilityAI, UTILITYAI_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Options Claimed In Group"), STAT_UtilityAI_OptionsClaimedInGroup, STATGROUP_UtilityAI, UTILITYAI_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Group Rescores"), STAT_UtilityAI_GroupRescores, STATGROUP_UtilityAI, UTILITYAI_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Async Input Rescores"), STAT_UtilityAI_AsyncRescores, STATGROUP_UtilityAI, UTILITYAI_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Tree Restarts"), STAT_UtilityAI_TreeRestarts, STATGROUP_UtilityAI, UTILITYAI_API);
+
+
+// --- CSV profiler (csvprofile start) ---
+
+// Decisions, DecisionMs, OptionSwitches and TreeRestarts per frame, plus the time spent running decision makers
+CSV_DECLARE_CATEGORY_MODULE_EXTERN(UTILITYAI_API, UtilityAI);
+
+
+// --- Insights ---
+
+// Per option and per consideration events. Too noisy for the cpu channel, so turn it on with -trace=default,UtilityAI
+UE_TRACE_CHANNEL_EXTERN(UtilityAIChannel, UTILITYAI_API);
+
+#if CPUPROFILERTRACE_ENABLED
+// Trace scope named at runtime. The name is only built when the UtilityAI channel is on.
+#define UTILITYAI_TRACE_SCOPE_DYNAMIC(NameExpression) \
+	TOptional<FCpuProfilerTrace::FDynamicEventScope> PREPROCESSOR_JOIN(UtilityAITraceScope, __LINE__); \
+	if (UE_TRACE_CHANNELEXPR_IS_ENABLED(UtilityAIChannel)) \
+	{ \
+		PREPROCESSOR_JOIN(UtilityAITraceScope, __LINE__).Emplace(*(NameExpression), UtilityAIChannel); \
+	}
+#else
+#define UTILITYAI_TRACE_SCOPE_DYNAMIC(NameExpression)
+#endif
+
+
+// --- Scoring threads ---
+
+/**
+ * Marks the current thread as scoring options for a decision maker while in scope. Tools use it to tell decision work apart
+ * from whatever else runs on the worker threads, eg. the benchmark's allocation counter.
+ */
+class UTILITYAI_API FAIScoringThreadScope
+{
+public:
+
+	FAIScoringThreadScope();
+	~FAIScoringThreadScope();
+
+	// Is this thread inside a scope?
+	static bool IsActive();
+};
+
+
+// --- Consideration timings ---
+
+/**
+ * Histogram of how long each consideration class takes to score, to find the ones eating the frame budget.
+ * Only collected while UtilityAI.CollectTimings is on. Print with UtilityAI.DumpConsiderationTimings.
+ */
+class UTILITYAI_API FAIConsiderationTimings
+{
+public:
+
+	// Bucket i holds scores that took less than 4^i microseconds. The last bucket holds everything slower.
+	static constexpr int32 NumBuckets = 8;
+
+	struct FClassTimings
+	{
+		FString ClassName;
+
+		bool bNative = false;
+
+		uint64 Count = 0;
+
+		double TotalSeconds = 0;
+
+		double MaxSeconds = 0;
+
+		uint64 Buckets[NumBuckets] = {};
+	};
+
+	static FAIConsiderationTimings& Get();
+
+	static bool IsEnabled();
+
+	// Safe to call from scoring worker threads. Batches add their total time, counted as NumScores scores of the average time.
+	void Add(const UClass* ConsiderationClass, double Seconds, int32 NumScores = 1);
+
+	void Reset();
+
+	// Slowest classes (by total time) first
+	void GetTimings(TArray<FClassTimings>& OutTimings) const;
+
+	void Dump(FOutputDevice& Ar) const;
+
+private:
+
+	mutable FCriticalSection Lock;
+
+	TMap<FObjectKey, FClassTimings> Timings;
+};
+
+
+// --- Decision metrics ---
+
+/**
+ * Running totals of how many decisions are made and how long they take, cheap enough to leave on under live load.
+ * Collected while UtilityAI.CollectMetrics is on. Print with UtilityAI.Stats and UtilityAI.Top, or log them every
+ * UtilityAI.LogStatsInterval seconds on servers without a console.
+ */
+class UTILITYAI_API FAIDecisionMetrics
+{
+public:
+
+	// Bucket i holds decisions that took less than 2^i microseconds. The last bucket holds everything slower.
+	static constexpr int32 NumBuckets = 16;
+
+	struct FTotals
+	{
+		double Seconds = 0;
+
+		uint64 Decisions = 0;
+
+		uint64 OptionSwitches = 0;
+
+		uint64 TreeRestarts = 0;
+
+		double DecisionSeconds = 0;
+
+		double MaxDecisionSeconds = 0;
+
+		uint64 Buckets[NumBuckets] = {};
+
+		// Upper bound of the bucket the percentile falls in. Percentile is 0 to 1.
+		double GetPercentileSeconds(double Percentile) const;
+
+		// What happened since Earlier was taken. Max times can't be taken apart, so they're kept from this one.
+		FTotals GetDelta(const FTotals& Earlier) const;
+	};
+
+	// Decisions made by agents with the same option sets
+	struct FOptionSetMetrics
+	{
+		FName Name;
+
+		uint64 Decisions = 0;
+
+		double TotalSeconds = 0;
+
+		double MaxSeconds = 0;
+	};
+
+	static FAIDecisionMetrics& Get();
+
+	static bool IsEnabled();
+
+	// Safe to call from any thread. OptionSetsName is the FAISortedOptionList the decision was scored from.
+	void AddDecision(FName OptionSetsName, double Seconds, bool bSwitchedOption);
+
+	// Add decisions that were timed together, eg. a Mass chunk. They go in the histogram at their average time.
+	void AddDecisions(FName OptionSetsName, int32 NumDecisions, double Seconds, int32 NumSwitchedOptions);
+
+	void AddTreeRestart();
+
+	void Reset();
+
+	FTotals GetTotals() const;
+
+	// Most expensive (by total time) first
+	void GetOptionSets(TArray<FOptionSetMetrics>& OutOptionSets) const;
+
+	// Print totals since the last reset
+	void Dump(FOutputDevice& Ar) const;
+
+	static void DumpTotals(const FTotals& Summary, FOutputDevice& Ar);
+
+	// Print the option sets that take the most time
+	void DumpTopOptionSets(int32 MaxOptionSets, FOutputDevice& Ar) const;
+
+	// Log what's happened since the last call, if UtilityAI.LogStatsInterval has passed. Call from the game thread.
+	void LogIfDue();
+
+private:
+
+	FAIDecisionMetrics();
+
+	void AddLocked(FName OptionSetsName, int32 NumDecisions, double Seconds, double SecondsEach, int32 NumSwitchedOptions);
+
+	mutable FCriticalSection Lock;
+
+	double StartSeconds = 0;
+
+	FTotals Totals;
+
+	TMap<FName, FOptionSetMetrics> OptionSets;
+
+	// What Totals were at the last periodic log
+	FTotals LoggedTotals;
+};
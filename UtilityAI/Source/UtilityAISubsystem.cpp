@@ -0,0 +1,240 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "UtilityAISubsystem.h"
+#include "DecisionMakerComponent.h"
+#include "UtilityAIStats.h"
+#include "Engine/World.h"
+
+
+TAutoConsoleVariable<float> CVarUtilityAIFrameBudgetMs(
+	TEXT("UtilityAI.FrameBudgetMs"),
+	0.f,
+	TEXT("Time budget (in milliseconds) for running decision makers each frame.\n")
+	TEXT("Decision makers that don't fit in the budget run first on the next frame.\n")
+	TEXT("  0: unlimited\n")
+);
+
+
+
+void UUtilityAISubsystem::Deinitialize()
+{
+	for (TPair<FName, TUniquePtr<FAIDecisionGroup>>& Group : DecisionGroups)
+	{
+		Group.Value->RemoveAllMembers();
+	}
+	DecisionGroups.Reset();
+
+	for (UDecisionMakerComponent* DecisionMaker : DecisionMakers)
+	{
+		if (DecisionMaker)
+		{
+			DecisionMaker->SubsystemIndex = INDEX_NONE;
+		}
+	}
+	DecisionMakers.Reset();
+	NumHoles = 0;
+	NextDecisionMakerIndex = 0;
+
+	Super::Deinitialize();
+}
+
+void UUtilityAISubsystem::Tick(float DeltaTime)
+{
+	// Last frame's results are stale
+	FrameQueryCache.ResetIfNewFrame(GFrameCounter);
+
+	if (UWorld* World = GetWorld())
+	{
+		RunDecisionMakers(World->GetTimeSeconds());
+	}
+}
+
+bool UUtilityAISubsystem::IsTickable() const
+{
+	return DecisionMakers.Num() > 0;
+}
+
+ETickableTickType UUtilityAISubsystem::GetTickableTickType() const
+{
+	// The CDO shouldn't tick
+	return IsTemplate() ? ETickableTickType::Never : ETickableTickType::Conditional;
+}
+
+UWorld* UUtilityAISubsystem::GetTickableGameObjectWorld() const
+{
+	return GetWorld();
+}
+
+TStatId UUtilityAISubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UUtilityAISubsystem, STATGROUP_Tickables);
+}
+
+void UUtilityAISubsystem::RegisterDecisionMaker(UDecisionMakerComponent* DecisionMaker)
+{
+	if (!DecisionMaker)
+		return;
+
+	if (DecisionMaker->SubsystemIndex == INDEX_NONE)
+	{
+		DecisionMaker->SubsystemIndex = DecisionMakers.Add(DecisionMaker);
+	}
+	JoinDecisionGroup(DecisionMaker);
+}
+
+void UUtilityAISubsystem::UnregisterDecisionMaker(UDecisionMakerComponent* DecisionMaker)
+{
+	LeaveDecisionGroup(DecisionMaker);
+
+	const int32 Index = DecisionMaker ? DecisionMaker->SubsystemIndex : INDEX_NONE;
+	if (!DecisionMakers.IsValidIndex(Index) || DecisionMakers[Index] != DecisionMaker)
+		return;
+
+	// Removing would shift everyone after us, so leave a hole for the next compaction
+	DecisionMakers[Index] = nullptr;
+	DecisionMaker->SubsystemIndex = INDEX_NONE;
+	++NumHoles;
+}
+
+int32 UUtilityAISubsystem::GetNumDecisionMakers() const
+{
+	return DecisionMakers.Num() - NumHoles;
+}
+
+void UUtilityAISubsystem::JoinDecisionGroup(UDecisionMakerComponent* DecisionMaker)
+{
+	if (!DecisionMaker || DecisionMaker->DecisionGroupName.IsNone() || DecisionMaker->GetDecisionGroup())
+		return;
+
+	TUniquePtr<FAIDecisionGroup>& Group = DecisionGroups.FindOrAdd(DecisionMaker->DecisionGroupName);
+	if (!Group)
+	{
+		Group = MakeUnique<FAIDecisionGroup>(DecisionMaker->DecisionGroupName);
+	}
+	Group->AddMember(DecisionMaker);
+}
+
+void UUtilityAISubsystem::LeaveDecisionGroup(UDecisionMakerComponent* DecisionMaker)
+{
+	FAIDecisionGroup* Group = DecisionMaker ? DecisionMaker->GetDecisionGroup() : nullptr;
+	if (!Group)
+		return;
+
+	Group->RemoveMember(DecisionMaker);
+
+	// The loop might be running this group's decisions, so leave it for the cleanup after the loop
+	if (Group->Num() == 0 && !bIsRunningDecisionMakers)
+	{
+		DecisionGroups.Remove(Group->GetName());
+	}
+}
+
+FAIDecisionGroup* UUtilityAISubsystem::FindDecisionGroup(FName GroupName) const
+{
+	const TUniquePtr<FAIDecisionGroup>* Group = DecisionGroups.Find(GroupName);
+	return Group ? Group->Get() : nullptr;
+}
+
+int32 UUtilityAISubsystem::GetNumDecisionGroups() const
+{
+	return DecisionGroups.Num();
+}
+
+FAIQueryCache& UUtilityAISubsystem::GetFrameQueryCache()
+{
+	// Decision makers can also run outside our tick, so make sure we're not handing out last frame's results
+	FrameQueryCache.ResetIfNewFrame(GFrameCounter);
+	return FrameQueryCache;
+}
+
+void UUtilityAISubsystem::CompactDecisionMakers()
+{
+	int32 NumKept = 0;
+	int32 NumRemovedBeforeCursor = 0;
+	for (int32 Index = 0; Index < DecisionMakers.Num(); ++Index)
+	{
+		UDecisionMakerComponent* DecisionMaker = DecisionMakers[Index];
+		if (!IsValid(DecisionMaker))
+		{
+			if (DecisionMaker)
+			{
+				DecisionMaker->SubsystemIndex = INDEX_NONE;
+			}
+			NumRemovedBeforeCursor += Index < NextDecisionMakerIndex ? 1 : 0;
+			continue;
+		}
+
+		DecisionMakers[NumKept] = DecisionMaker;
+		DecisionMaker->SubsystemIndex = NumKept;
+		++NumKept;
+	}
+
+	DecisionMakers.SetNum(NumKept, EAllowShrinking::No);
+	NumHoles = 0;
+
+	// Everything after the cursor has moved down by however many holes were before it
+	NextDecisionMakerIndex = NumKept > 0 ? (NextDecisionMakerIndex - NumRemovedBeforeCursor) % NumKept : 0;
+}
+
+void UUtilityAISubsystem::RunDecisionMakers(double CurrentTime)
+{
+	// New decision makers registered during the loop will wait until next frame
+	const int32 NumDecisionMakers = DecisionMakers.Num();
+	if (NumDecisionMakers == 0)
+		return;
+
+	CSV_SCOPED_TIMING_STAT(UtilityAI, RunDecisionMakers);
+
+	const double BudgetSeconds = CVarUtilityAIFrameBudgetMs.GetValueOnGameThread() / 1000.0;
+	const double StartSeconds = FPlatformTime::Seconds();
+
+	bIsRunningDecisionMakers = true;
+
+	const int32 FirstIndex = NextDecisionMakerIndex % NumDecisionMakers;
+	int32 NumVisited = 0;
+
+	while (NumVisited < NumDecisionMakers)
+	{
+		UDecisionMakerComponent* DecisionMaker = DecisionMakers[(FirstIndex + NumVisited) % NumDecisionMakers];
+		++NumVisited;
+
+		if (!IsValid(DecisionMaker))
+			continue;
+
+		// Agents the budget doesn't reach update their LOD when they come round first next frame
+		DecisionMaker->UpdateLOD(CurrentTime);
+
+		if (!DecisionMaker->IsDecisionDue(CurrentTime))
+			continue;
+
+		if (FAIDecisionGroup* Group = DecisionMaker->GetDecisionGroup())
+		{
+			// The whole group decides when its first member is due
+			Group->RunDecisions(CurrentTime);
+		}
+		else
+		{
+			DecisionMaker->RunDecisionMaker();
+			DecisionMaker->ScheduleNextDecision(CurrentTime);
+		}
+
+		if (BudgetSeconds > 0 && FPlatformTime::Seconds() - StartSeconds >= BudgetSeconds)
+			break;
+	}
+
+	NextDecisionMakerIndex = (FirstIndex + NumVisited) % NumDecisionMakers;
+
+	bIsRunningDecisionMakers = false;
+
+	// Clean up anything that unregistered (or was destroyed)
+	CompactDecisionMakers();
+
+	for (auto It = DecisionGroups.CreateIterator(); It; ++It)
+	{
+		if (It.Value()->Num() == 0)
+		{
+			It.RemoveCurrent();
+		}
+	}
+}
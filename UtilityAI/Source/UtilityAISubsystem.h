@@ -0,0 +1,76 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "AIQueryCache.h"
+#include "AIDecisionGroup.h"
+#include "UtilityAISubsystem.generated.h"
+
+
+class UDecisionMakerComponent;
+
+/**
+ * Runs every active decision maker in the world from one loop, instead of each component ticking itself.
+ * Agents are visited round-robin so that when the frame budget runs out, the agents that missed out go first next frame.
+ * Decision makers with a DecisionGroupName are run together with the rest of their group.
+ */
+UCLASS()
+class UTILITYAI_API UUtilityAISubsystem : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+public:
+
+	virtual void Deinitialize() override;
+
+	// --- FTickableGameObject ---
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual ETickableTickType GetTickableTickType() const override;
+	virtual UWorld* GetTickableGameObjectWorld() const override;
+	virtual TStatId GetStatId() const override;
+
+	void RegisterDecisionMaker(UDecisionMakerComponent* DecisionMaker);
+	void UnregisterDecisionMaker(UDecisionMakerComponent* DecisionMaker);
+
+	int32 GetNumDecisionMakers() const;
+
+	// Put a registered decision maker in the group named by its DecisionGroupName, creating the group if needed
+	void JoinDecisionGroup(UDecisionMakerComponent* DecisionMaker);
+	void LeaveDecisionGroup(UDecisionMakerComponent* DecisionMaker);
+
+	FAIDecisionGroup* FindDecisionGroup(FName GroupName) const;
+
+	int32 GetNumDecisionGroups() const;
+
+	// Query results shared by all decision makers this frame
+	FAIQueryCache& GetFrameQueryCache();
+
+protected:
+
+	// Run decision makers that are due, starting from the round-robin cursor, until we run out of budget
+	void RunDecisionMakers(double CurrentTime);
+
+	// Close the holes left by decision makers that unregistered or were destroyed, keeping the cursor on the same decision maker
+	void CompactDecisionMakers();
+
+	// Each decision maker knows its index here, so registering doesn't have to search. Unregistering leaves a hole until the next compaction.
+	UPROPERTY(Transient)
+	TArray<UDecisionMakerComponent*> DecisionMakers;
+
+	// Holes left by unregistering since the last compaction
+	int32 NumHoles = 0;
+
+	// Index of the next decision maker to visit. Carries over between frames.
+	int32 NextDecisionMakerIndex = 0;
+
+	// Set while RunDecisionMakers is iterating
+	bool bIsRunningDecisionMakers = false;
+
+	FAIQueryCache FrameQueryCache;
+
+	// Groups are only created and destroyed on the game thread. Empty groups are removed once the loop isn't using them.
+	TMap<FName, TUniquePtr<FAIDecisionGroup>> DecisionGroups;
+};
@@ -0,0 +1,24 @@
+// Alex Hajdu, (C) 2018, alexhajdu[at]me.com, twitter.com/alexhajdu
+
+using UnrealBuildTool;
+
+public
+class UtilityAIMass : ModuleRules
+{
+public
+	UtilityAIMass( ReadOnlyTargetRules Target )
+		: base( Target )
+	{
+		PCHUsage = ModuleRules.PCHUsageMode.UseExplicitOrSharedPCHs;
+
+		// Lives in its own plugin, so only projects that enable UtilityAIMass need MassEntity
+		PublicDependencyModuleNames.AddRange( new string[]{
+			"Core", "CoreUObject", "MassEntity", "UtilityAI"
+		} );
+
+
+		PrivateDependencyModuleNames.AddRange( new string[]{
+			"Engine", "AIModule", "GameplayTags"
+		});
+	}
+}
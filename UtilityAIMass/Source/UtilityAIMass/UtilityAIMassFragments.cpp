@@ -0,0 +1,48 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "UtilityAIMassFragments.h"
+#include "AIOption.h"
+
+
+FAIOptionSelector FUtilityAIOptionSetFragment::GetOptionSelector() const
+{
+	FAIOptionSelector Selector;
+	Selector.Strategy = SelectionStrategy;
+	Selector.MinimumWeightFraction = MinimumWeightFractionForRandomSelection;
+	Selector.SoftmaxTemperature = SoftmaxTemperature;
+	return Selector;
+}
+
+void FUtilityAIHistoryFragment::StartOption(FName OptionName, float Timestamp)
+{
+	CurrentRecord = FDecisionRecord();
+	CurrentRecord.OptionName = OptionName;
+	CurrentRecord.StartedTimestamp = Timestamp;
+	CurrentRecord.Result = EDecisionHistoryQueryResult::InProgress;
+	RunningOption = nullptr;
+}
+
+void FUtilityAIHistoryFragment::StartOption(const UAIOption* Option, float Timestamp)
+{
+	StartOption(Option ? Option->OptionName : NAME_None, Timestamp);
+	RunningOption = Option;
+}
+
+void FUtilityAIHistoryFragment::EndOption(EDecisionHistoryQueryResult Result, float Timestamp)
+{
+	if (!IsOptionInProgress())
+		return;
+
+	CurrentRecord.EndedTimestamp = Timestamp;
+	CurrentRecord.Result = Result;
+	History.Add(CurrentRecord);
+
+	if (RunningOption)
+	{
+		Cooldowns.Start(RunningOption->GetCooldownName(), Timestamp, RunningOption->GetCooldownTime(Result));
+	}
+
+	CurrentRecord = FDecisionRecord();
+	RunningOption = nullptr;
+}
@@ -0,0 +1,118 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Misc/EngineVersionComparison.h"
+#include "MassEntityTypes.h"
+#include "AIOptionSelector.h"
+#include "DecisionHistory.h"
+#include "AICooldownStore.h"
+#include "UtilityAIMassFragments.generated.h"
+
+
+class UAIOption;
+class UAIOptionSetDataAsset;
+
+/**
+ * What a group of Mass entities can decide to do, and how. Shared by every entity with the same settings.
+ * Keep the option set assets referenced somewhere else (eg. by your entity config) while entities use them.
+ */
+USTRUCT()
+struct UTILITYAIMASS_API FUtilityAIOptionSetFragment : public FMassSharedFragment
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, Category = "UtilityAI")
+	TArray<UAIOptionSetDataAsset*> OptionSets;
+
+	UPROPERTY(EditAnywhere, Category = "UtilityAI")
+	EAIOptionSelectionStrategy SelectionStrategy = EAIOptionSelectionStrategy::TopFraction;
+
+	UPROPERTY(EditAnywhere, Category = "UtilityAI", meta = (ClampMin = "0", ClampMax = "1", EditCondition = "SelectionStrategy == EAIOptionSelectionStrategy::TopFraction"))
+	float MinimumWeightFractionForRandomSelection = 0.95f;
+
+	UPROPERTY(EditAnywhere, Category = "UtilityAI", meta = (ClampMin = "0", EditCondition = "SelectionStrategy == EAIOptionSelectionStrategy::Softmax"))
+	float SoftmaxTemperature = 1.f;
+
+	/** How many decisions each entity makes per second. 0 means decide every frame. */
+	UPROPERTY(EditAnywhere, Category = "UtilityAI", meta = (ClampMin = "0"))
+	float DecisionRate = 1.f;
+
+	FAIOptionSelector GetOptionSelector() const;
+
+	float GetDecisionInterval() const { return DecisionRate > 0 ? 1.f / DecisionRate : 0.f; }
+};
+
+
+/**
+ * The latest decision of one Mass entity. Your own processors read CurrentOption to act on it.
+ */
+USTRUCT()
+struct UTILITYAIMASS_API FUtilityAIDecisionFragment : public FMassFragment
+{
+	GENERATED_BODY()
+
+	// Fragments aren't seen by the garbage collector. The option is kept alive by its option set asset.
+	UAIOption* CurrentOption = nullptr;
+
+	FName CurrentOptionName;
+
+	float CurrentWeight = 0.f;
+
+	// Set when CurrentOption changes. Clear it once you've handled the change.
+	bool bOptionChanged = false;
+
+	double NextDecisionTime = 0;
+
+	// Seeded from the entity the first time it decides, unless you seed it yourself
+	FRandomStream RandomStream;
+
+	bool bRandomStreamSeeded = false;
+
+	// Decide again as soon as possible, eg. when the current option's behavior has finished
+	void RequestDecision() { NextDecisionTime = 0; }
+};
+
+
+/**
+ * Decision history of one Mass entity. Capacity starts at 0, which keeps no records but still answers history queries.
+ * Not trivially copyable: it keeps the same indexed FDecisionHistory and FAICooldownStore as the component, so history
+ * considerations read entities and components the same way. See the TMassFragmentTraits specialization below.
+ */
+USTRUCT()
+struct UTILITYAIMASS_API FUtilityAIHistoryFragment : public FMassFragment
+{
+	GENERATED_BODY()
+
+	FDecisionRecord CurrentRecord;
+
+	FDecisionHistory History;
+
+	FAICooldownStore Cooldowns;
+
+	// The option CurrentRecord is for, so its cooldown can be started when it ends
+	const UAIOption* RunningOption = nullptr;
+
+	// Start a record for a newly selected option
+	void StartOption(FName OptionName, float Timestamp);
+	void StartOption(const UAIOption* Option, float Timestamp);
+
+	// Finish the current record and move it to the history, and start the option's cooldown. Call this with the result when an option's behavior ends.
+	void EndOption(EDecisionHistoryQueryResult Result, float Timestamp);
+
+	bool IsOptionInProgress() const { return CurrentRecord.StartedTimestamp > 0; }
+};
+
+#if !UE_VERSION_OLDER_THAN(5, 3, 0)
+// Mass moves fragments between chunks with a plain memory copy. The history's TArray/TMap and the cooldown store's inline
+// array only hold their own heap pointers (no pointers back into the fragment), so moving their bytes is safe.
+template<>
+struct TMassFragmentTraits<FUtilityAIHistoryFragment> final
+{
+	enum
+	{
+		AuthorAcceptsItsNotTriviallyCopyable = true
+	};
+};
+#endif
@@ -0,0 +1,202 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "UtilityAIMassProcessor.h"
+#include "UtilityAIMassFragments.h"
+#include "AIOptionSetDataAsset.h"
+#include "AIOption.h"
+#include "UtilityAISubsystem.h"
+#include "UtilityAIStats.h"
+#include "MassEntitySubsystem.h"
+#include "Async/ParallelFor.h"
+#include "Misc/App.h"
+#include "HAL/IConsoleManager.h"
+#include <atomic>
+
+#if UTILITYAI_WITH_MASS_ENTITY_MANAGER
+#include "MassExecutionContext.h"
+#endif
+
+
+UUtilityAIMassProcessor::UUtilityAIMassProcessor()
+{
+	// Considerations that aren't thread-safe (including all Blueprint ones) have to run on the game thread.
+	// Thread-safe chunks still go wide with ParallelFor.
+	bRequiresGameThreadExecution = true;
+
+#if UTILITYAI_WITH_MASS_ENTITY_MANAGER
+	EntityQuery.RegisterWithProcessor(*this);
+#endif
+}
+
+void UUtilityAIMassProcessor::ConfigureQueries()
+{
+	EntityQuery.AddRequirement<FUtilityAIDecisionFragment>(EMassFragmentAccess::ReadWrite);
+	EntityQuery.AddRequirement<FUtilityAIHistoryFragment>(EMassFragmentAccess::ReadWrite);
+	EntityQuery.AddSharedRequirement<FUtilityAIOptionSetFragment>(EMassFragmentAccess::ReadOnly);
+}
+
+void UUtilityAIMassProcessor::Execute(FUtilityAIMassEntityManager& EntityManager, FMassExecutionContext& Context)
+{
+	SCOPE_CYCLE_COUNTER(STAT_UtilityAI_MassDecisions);
+	CSV_SCOPED_TIMING_STAT(UtilityAI, MassDecisions);
+
+	UWorld* World = EntityManager.GetWorld();
+	if (!World)
+		return;
+
+	UUtilityAISubsystem* Subsystem = World->GetSubsystem<UUtilityAISubsystem>();
+
+	FDecisionMakerContext BaseContext;
+	BaseContext.CurrentTime = World->GetTimeSeconds();
+	BaseContext.FrameQueryCache = Subsystem ? &Subsystem->GetFrameQueryCache() : nullptr;
+
+	// Decision makers own UtilityAI.ParallelScoring, so look it up rather than linking to it
+	static const IConsoleVariable* ParallelScoringCVar = IConsoleManager::Get().FindConsoleVariable(TEXT("UtilityAI.ParallelScoring"));
+	const bool bAllowParallel = (!ParallelScoringCVar || ParallelScoringCVar->GetInt() != 0) && FApp::ShouldUseThreadingForPerformance();
+
+	EntityQuery.ForEachEntityChunk(EntityManager, Context, [&](FMassExecutionContext& ChunkContext)
+	{
+		const FUtilityAIOptionSetFragment& OptionSetFragment = ChunkContext.GetSharedFragment<FUtilityAIOptionSetFragment>();
+		const TArrayView<FUtilityAIDecisionFragment> Decisions = ChunkContext.GetMutableFragmentView<FUtilityAIDecisionFragment>();
+		const TArrayView<FUtilityAIHistoryFragment> Histories = ChunkContext.GetMutableFragmentView<FUtilityAIHistoryFragment>();
+
+		UpdateSortedOptions(OptionSetFragment);
+
+		FDecisionMakerContext ChunkBaseContext = BaseContext;
+		ChunkBaseContext.MassContext = &ChunkContext;
+
+		// Entities are timed together, since timing each one would cost more than some of their decisions
+		const double ChunkStartSeconds = FPlatformTime::Seconds();
+		std::atomic<int32> NumDecided(0);
+		std::atomic<int32> NumSwitched(0);
+
+		auto RunEntity = [&](int32 EntityIndex)
+		{
+			FDecisionMakerContext EntityContext = ChunkBaseContext;
+			EntityContext.MassEntityIndex = EntityIndex;
+			const EUtilityAIMassDecision Result = RunDecision(OptionSetFragment, EntityContext, Decisions[EntityIndex], Histories[EntityIndex], ChunkContext.GetEntity(EntityIndex).Index);
+			if (Result != EUtilityAIMassDecision::NotDue)
+			{
+				NumDecided.fetch_add(1, std::memory_order_relaxed);
+				if (Result == EUtilityAIMassDecision::SwitchedOption)
+				{
+					NumSwitched.fetch_add(1, std::memory_order_relaxed);
+				}
+			}
+		};
+
+		const int32 NumEntities = ChunkContext.GetNumEntities();
+		if (bAllowParallel && SortedOptionList->bAllThreadSafe)
+		{
+			ParallelFor(NumEntities, RunEntity);
+		}
+		else
+		{
+			for (int32 EntityIndex = 0; EntityIndex < NumEntities; ++EntityIndex)
+			{
+				RunEntity(EntityIndex);
+			}
+		}
+
+		if (NumDecided > 0 && FAIDecisionMetrics::IsEnabled())
+		{
+			FAIDecisionMetrics::Get().AddDecisions(SortedOptionList->Name, NumDecided, FPlatformTime::Seconds() - ChunkStartSeconds, NumSwitched);
+		}
+	});
+}
+
+void UUtilityAIMassProcessor::UpdateSortedOptions(const FUtilityAIOptionSetFragment& OptionSetFragment)
+{
+	// Neighbouring chunks usually share option sets. Compiled sets are replaced (not modified) when their asset changes.
+	const TArrayView<const TSharedRef<const FAICompiledOptionSet>> SortedSources = SortedOptionList ? MakeArrayView(SortedOptionList->Sources) : TArrayView<const TSharedRef<const FAICompiledOptionSet>>();
+
+	bool bChanged = false;
+	int32 NumSources = 0;
+	for (UAIOptionSetDataAsset* OptionSet : OptionSetFragment.OptionSets)
+	{
+		if (!OptionSet)
+			continue;
+
+		if (!SortedSources.IsValidIndex(NumSources) || SortedSources[NumSources] != OptionSet->GetCompiledOptionSet())
+		{
+			bChanged = true;
+			break;
+		}
+		++NumSources;
+	}
+
+	if (SortedOptionList && !bChanged && NumSources == SortedSources.Num())
+		return;
+
+	TArray<TSharedRef<const FAICompiledOptionSet>, TInlineAllocator<8>> CompiledOptionSets;
+	for (UAIOptionSetDataAsset* OptionSet : OptionSetFragment.OptionSets)
+	{
+		if (OptionSet)
+		{
+			CompiledOptionSets.Add(OptionSet->GetCompiledOptionSet());
+		}
+	}
+
+	// Shared with decision makers (and other processors) using the same sets
+	SortedOptionList = FAISortedOptionList::Get(CompiledOptionSets);
+}
+
+EUtilityAIMassDecision UUtilityAIMassProcessor::RunDecision(const FUtilityAIOptionSetFragment& OptionSetFragment, const FDecisionMakerContext& BaseContext,
+	FUtilityAIDecisionFragment& Decision, FUtilityAIHistoryFragment& History, int32 EntitySeed) const
+{
+	const double CurrentTime = BaseContext.CurrentTime;
+	const float DecisionInterval = OptionSetFragment.GetDecisionInterval();
+
+	// Spread the first decision over one interval so entities spawned together don't all decide on the same frame
+	if (!Decision.bRandomStreamSeeded)
+	{
+		Decision.RandomStream.Initialize(EntitySeed);
+		Decision.bRandomStreamSeeded = true;
+		Decision.NextDecisionTime = CurrentTime + Decision.RandomStream.FRand() * DecisionInterval;
+	}
+
+	if (CurrentTime < Decision.NextDecisionTime)
+		return EUtilityAIMassDecision::NotDue;
+
+	Decision.NextDecisionTime = CurrentTime + DecisionInterval;
+
+	FDecisionMakerContext Context = BaseContext;
+	Context.DecisionHistory = &History.History;
+	Context.CurrentDecisionRecord = &History.CurrentRecord;
+	Context.Cooldowns = &History.Cooldowns;
+
+	// Entities can run on any worker, so each thread keeps its own scores buffer
+	static thread_local TArray<FAIOptionScore> Scores;
+	const TArrayView<const FAIOptionRef> SortedOptions = SortedOptionList->Options;
+	Scores.SetNum(SortedOptions.Num(), EAllowShrinking::No);
+
+	const FAIOptionSelector Selector = OptionSetFragment.GetOptionSelector();
+
+	int32 RankStart = 0;
+	int32 RankNum = 0;
+	const float BestWeight = AIOptionRanking::ScoreBestRank(SortedOptions, Context, Selector.GetPruneFraction(), Scores, RankStart, RankNum);
+
+	const TArrayView<const FAIOptionScore> RankScores = MakeArrayView(Scores.GetData() + RankStart, RankNum);
+	const int32 SelectedIndex = Selector.Select(RankScores, BestWeight, Decision.RandomStream);
+	if (!RankScores.IsValidIndex(SelectedIndex))
+		return EUtilityAIMassDecision::KeptOption;
+
+	const FAIOptionScore& SelectedScore = RankScores[SelectedIndex];
+	Decision.CurrentWeight = SelectedScore.Weight;
+
+	if (SelectedScore.Option == Decision.CurrentOption && History.IsOptionInProgress())
+		return EUtilityAIMassDecision::KeptOption;
+
+	// Whatever was running didn't get to finish
+	History.EndOption(EDecisionHistoryQueryResult::Aborted, CurrentTime);
+
+	const UAIOption* PreviousOption = Decision.CurrentOption;
+	Decision.CurrentOption = SelectedScore.Option;
+	Decision.CurrentOptionName = SelectedScore.Option ? SelectedScore.Option->OptionName : NAME_None;
+	Decision.bOptionChanged = true;
+
+	History.StartOption(SelectedScore.Option, CurrentTime);
+
+	return Decision.CurrentOption != PreviousOption ? EUtilityAIMassDecision::SwitchedOption : EUtilityAIMassDecision::KeptOption;
+}
@@ -0,0 +1,67 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MassProcessor.h"
+#include "MassEntityQuery.h"
+#include "AICompiledOptionSet.h"
+#include "UtilityAIMassProcessor.generated.h"
+
+
+struct FUtilityAIOptionSetFragment;
+struct FUtilityAIDecisionFragment;
+struct FUtilityAIHistoryFragment;
+
+// Processors were handed the UMassEntitySubsystem in 5.0, and an FMassEntityManager from 5.1
+#define UTILITYAI_WITH_MASS_ENTITY_MANAGER (ENGINE_MAJOR_VERSION > 5 || (ENGINE_MAJOR_VERSION == 5 && ENGINE_MINOR_VERSION >= 1))
+
+#if UTILITYAI_WITH_MASS_ENTITY_MANAGER
+struct FMassEntityManager;
+using FUtilityAIMassEntityManager = FMassEntityManager;
+#else
+class UMassEntitySubsystem;
+using FUtilityAIMassEntityManager = UMassEntitySubsystem;
+#endif
+
+/** What RunDecision did for one entity */
+enum class EUtilityAIMassDecision : uint8
+{
+	NotDue,
+	KeptOption,
+	SwitchedOption
+};
+
+/**
+ * Makes utility decisions for Mass entities, with the same option set assets, compiled sets, selector and history as UDecisionMakerComponent.
+ * Entities need FUtilityAIDecisionFragment, FUtilityAIHistoryFragment and a shared FUtilityAIOptionSetFragment.
+ * Every entity in a chunk shares its option sets, so options are sorted once per chunk, and the chunk's entities are scored
+ * in parallel when every option is thread-safe.
+ * Subclass and extend ConfigureQueries to let your considerations read more fragments through FDecisionMakerContext::MassContext.
+ */
+UCLASS()
+class UTILITYAIMASS_API UUtilityAIMassProcessor : public UMassProcessor
+{
+	GENERATED_BODY()
+public:
+
+	UUtilityAIMassProcessor();
+
+protected:
+
+	virtual void ConfigureQueries() override;
+
+	virtual void Execute(FUtilityAIMassEntityManager& EntityManager, FMassExecutionContext& Context) override;
+
+	// Get a new SortedOptionList if the chunk uses different option sets to the last one
+	void UpdateSortedOptions(const FUtilityAIOptionSetFragment& OptionSetFragment);
+
+	// Make one entity's decision, if it's due. Only touches the entity's own fragments, so entities can be run in parallel.
+	EUtilityAIMassDecision RunDecision(const FUtilityAIOptionSetFragment& OptionSetFragment, const FDecisionMakerContext& BaseContext,
+		FUtilityAIDecisionFragment& Decision, FUtilityAIHistoryFragment& History, int32 EntitySeed) const;
+
+	FMassEntityQuery EntityQuery;
+
+	// All options from the current chunk's option sets, sorted by rank
+	TSharedPtr<const FAISortedOptionList> SortedOptionList;
+};